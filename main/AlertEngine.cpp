@@ -0,0 +1,221 @@
+#include "AlertEngine.h"
+#include "LayoutConfig.h"
+
+#define FLASH_PERIOD_MS 500
+#define FLASH_DIM_OPA LV_OPA_20
+
+AlertEngine::AlertEngine()
+    : ruleCount(0), anyRaise(false), flashTimer(nullptr), flashOn(true) {
+    for (size_t i = 0; i < MAX_ALERT_RULES; ++i) {
+        lv_style_init(&styles[i]);
+    }
+}
+
+void AlertEngine::compile(JsonArrayConst ruleArray) {
+    bool anyFlash = false;
+    anyRaise = false;
+    ruleCount = 0;
+
+    for (JsonObjectConst source : ruleArray) {
+        if (ruleCount == MAX_ALERT_RULES) {
+            Serial.println("AlertEngine: too many rules, extra rules ignored");
+            break;
+        }
+
+        AlertRule& rule = rules[ruleCount];
+        const char* tag = source["Tag"];
+        rule.matchTag = tag != nullptr;
+        rule.tagHash = rule.matchTag ? hash(tag) : 0;
+        rule.tag = rule.matchTag ? tag : "";
+        rule.category = source["Category"] | "";
+        rule.componentName = source["ComponentName"] | "";
+        if (!rule.matchTag && rule.category.isEmpty() && rule.componentName.isEmpty()) {
+            continue; // A rule has to match something
+        }
+
+        rule.above = !source.containsKey("Below");
+        rule.threshold = rule.above ? (source["Above"] | 0.0f) : (source["Below"] | 0.0f);
+        rule.hysteresis = source["Hysteresis"] | 0.0f;
+        rule.flash = source["Flash"] | false;
+        rule.raise = source["Raise"] | false;
+        anyFlash = anyFlash || rule.flash;
+        anyRaise = anyRaise || rule.raise;
+
+        lv_color_t color = lv_color_hex(LayoutConfig::parseColor(source["Color"] | "#FF0000"));
+        rule.color = color;
+        lv_style_t* style = &styles[ruleCount];
+        lv_style_reset(style);
+        lv_style_set_text_color(style, color);
+        lv_style_set_arc_color(style, color);
+        lv_obj_report_style_change(style);
+        ruleCount++;
+    }
+
+    // Styles of removed rules may still be attached to widgets until they are rebound, make them neutral
+    for (size_t i = ruleCount; i < MAX_ALERT_RULES; ++i) {
+        lv_style_reset(&styles[i]);
+        lv_obj_report_style_change(&styles[i]);
+    }
+
+    // Rules may now match different sensors, every slot is matched and evaluated again
+    for (AlertSlot& slot : slots) {
+        slot.rule = slot.inUse ? matchRule(slot) : -1;
+        slot.active = false;
+        slot.hasValue = false;
+    }
+
+    if (anyFlash && flashTimer == nullptr) {
+        flashTimer = lv_timer_create(flashTimerCallback, FLASH_PERIOD_MS, this);
+    } else if (!anyFlash && flashTimer != nullptr) {
+        lv_timer_del(flashTimer);
+        flashTimer = nullptr;
+    }
+}
+
+uint16_t AlertEngine::slotFor(const String& source, const String& tag, const String& category, const String& componentName) {
+    // Slots are keyed by "source:tag", rules match the bare tag
+    uint32_t keyHash = hash(tag.c_str(), hash(":", hash(source.c_str())));
+    auto range = slotByKey.equal_range(keyHash);
+    for (auto found = range.first; found != range.second; ++found) {
+        const AlertSlot& slot = slots[found->second];
+        if (slot.tag == tag && slot.source == source) {
+            return found->second;
+        }
+    }
+
+    uint16_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else if (slots.size() < ALERT_NO_SLOT) {
+        slots.push_back(AlertSlot());
+        index = slots.size() - 1;
+    } else {
+        return ALERT_NO_SLOT;
+    }
+
+    // Rules are matched once per new sensor, not per frame
+    AlertSlot& slot = slots[index];
+    slot.inUse = true;
+    slot.active = false;
+    slot.hasValue = false;
+    slot.lastValue = 0;
+    slot.source = source;
+    slot.tag = tag;
+    slot.category = category;
+    slot.componentName = componentName;
+    slot.tagHash = hash(tag.c_str());
+    slot.rule = matchRule(slot);
+    slotByKey.insert(std::make_pair(keyHash, index));
+    return index;
+}
+
+void AlertEngine::releaseSource(const String& source) {
+    for (auto it = slotByKey.begin(); it != slotByKey.end();) {
+        AlertSlot& slot = slots[it->second];
+        if (slot.source != source) {
+            ++it;
+            continue;
+        }
+        // Strings are dropped now, the slot itself is reused by the next new sensor
+        slot = AlertSlot();
+        slot.rule = -1;
+        freeSlots.push_back(it->second);
+        it = slotByKey.erase(it);
+    }
+}
+
+bool AlertEngine::update(uint16_t index, float value) {
+    if (index >= slots.size()) {
+        return false;
+    }
+
+    AlertSlot& slot = slots[index];
+    if (slot.rule < 0 || (slot.hasValue && slot.lastValue == value)) {
+        return false; // Unchanged sensors are never evaluated
+    }
+    slot.hasValue = true;
+    slot.lastValue = value;
+
+    // Hysteresis: once active, the value has to move back past the threshold by this margin
+    const AlertRule& rule = rules[slot.rule];
+    float margin = slot.active ? rule.hysteresis : 0.0f;
+    bool active = rule.above ? value > rule.threshold - margin : value < rule.threshold + margin;
+    if (active == slot.active) {
+        return false;
+    }
+    slot.active = active;
+    return true;
+}
+
+lv_style_t* AlertEngine::styleFor(uint16_t index) const {
+    if (index >= slots.size() || !slots[index].active) {
+        return nullptr;
+    }
+    return const_cast<lv_style_t*>(&styles[slots[index].rule]);
+}
+
+bool AlertEngine::colorFor(uint16_t index, lv_color_t& color) const {
+    if (index >= slots.size() || !slots[index].active) {
+        return false;
+    }
+    color = rules[slots[index].rule].color;
+    return true;
+}
+
+bool AlertEngine::isRaised(uint16_t index) const {
+    return index < slots.size() && slots[index].active && rules[slots[index].rule].raise;
+}
+
+bool AlertEngine::hasRaiseRules() const {
+    return anyRaise;
+}
+
+size_t AlertEngine::slotCount() const {
+    return slotByKey.size();
+}
+
+int16_t AlertEngine::matchRule(const AlertSlot& slot) const {
+    for (size_t i = 0; i < ruleCount; ++i) {
+        const AlertRule& rule = rules[i];
+        if (rule.matchTag) {
+            if (rule.tagHash == slot.tagHash && rule.tag == slot.tag) {
+                return i;
+            }
+            continue;
+        }
+        if ((rule.category.isEmpty() || rule.category == slot.category) &&
+            (rule.componentName.isEmpty() || rule.componentName == slot.componentName)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint32_t AlertEngine::hash(const char* text, uint32_t seed) {
+    // FNV-1a, seed with a previous result to hash a concatenation
+    uint32_t value = seed;
+    for (; *text != '\0'; ++text) {
+        value ^= (uint8_t)*text;
+        value *= 16777619u;
+    }
+    return value;
+}
+
+void AlertEngine::flashTimerCallback(lv_timer_t* timer) {
+    AlertEngine* instance = (AlertEngine*)timer->user_data;
+    if (instance == nullptr) {
+        return;
+    }
+
+    // One style change per flashing rule, LVGL refreshes only the widgets using it
+    instance->flashOn = !instance->flashOn;
+    lv_opa_t opa = instance->flashOn ? LV_OPA_COVER : FLASH_DIM_OPA;
+    for (size_t i = 0; i < instance->ruleCount; ++i) {
+        if (instance->rules[i].flash) {
+            lv_style_set_text_opa(&instance->styles[i], opa);
+            lv_style_set_arc_opa(&instance->styles[i], opa);
+            lv_obj_report_style_change(&instance->styles[i]);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <lvgl.h>
+#include <unordered_map>
+#include <vector>
+
+#define MAX_ALERT_RULES 16
+#define ALERT_NO_SLOT 0xFFFF
+
+// Threshold rules from CustomMetadata["AlertRules"], e.g.
+//   {"Category": "Load", "ComponentName": "CPU", "Above": 90, "Hysteresis": 5, "Color": "#FF0000", "Flash": true}
+//   {"Tag": "GPU Temperature", "Above": 85, "Color": "#FFA000", "Raise": true}
+// A rule matches by Tag, or by Category and/or ComponentName. Each sensor gets a slot that
+// caches its matching rule, so a frame only costs one hash lookup per sensor and a rule check
+// only for sensors whose value changed, regardless of how many rules exist. Rules share one
+// pre-built style each instead of setting local styles on widgets. Slots are per source, so the
+// same tag from two hosts keeps separate alert state while matching the same rules. Hashes only
+// narrow the search, slots and tag rules also compare the strings. A source's slots are recycled
+// once the source is dropped.
+class AlertEngine {
+public:
+    AlertEngine();
+    void compile(JsonArrayConst rules); // Call when the rules change
+    uint16_t slotFor(const String& source, const String& tag, const String& category, const String& componentName);
+    void releaseSource(const String& source); // Frees the slots of a source that stopped sending
+    bool update(uint16_t slot, float value); // Returns true when the slot's alert state flipped
+    lv_style_t* styleFor(uint16_t slot) const; // nullptr when not alerting
+    bool colorFor(uint16_t slot, lv_color_t& color) const; // For parts drawn without styles, e.g. chart bars
+    bool isRaised(uint16_t slot) const;
+    bool hasRaiseRules() const;
+    size_t slotCount() const; // Slots in use
+
+private:
+    struct AlertRule {
+        uint32_t tagHash;
+        String tag;
+        bool matchTag;
+        String category;
+        String componentName;
+        bool above;
+        float threshold;
+        float hysteresis;
+        bool flash;
+        bool raise;
+        lv_color_t color;
+    };
+
+    struct AlertSlot {
+        int16_t rule; // -1 when no rule matches
+        bool inUse;   // False while on the free list
+        bool active;
+        bool hasValue;
+        float lastValue;
+        String source;
+        String tag;
+        String category;
+        String componentName;
+        uint32_t tagHash;
+    };
+
+    AlertRule rules[MAX_ALERT_RULES];
+    lv_style_t styles[MAX_ALERT_RULES]; // Fixed array: widgets keep pointers to these
+    size_t ruleCount;
+    bool anyRaise;
+    std::vector<AlertSlot> slots;
+    std::unordered_multimap<uint32_t, uint16_t> slotByKey; // keyHash to slot, colliding keys share a bucket
+    std::vector<uint16_t> freeSlots;
+    lv_timer_t* flashTimer;
+    bool flashOn;
+
+    int16_t matchRule(const AlertSlot& slot) const;
+    static uint32_t hash(const char* text, uint32_t seed = 2166136261u);
+    static void flashTimerCallback(lv_timer_t* timer);
+};
+
+#endif // ALERT_ENGINE_H
@@ -1,62 +1,135 @@
 #include "DisplayManager.h"
 #include <vector>
+#include <algorithm>
+#include <esp_heap_caps.h>
 
-#define DEFAULT_LABEL_FONT_SIZE 18
-#define DEFAULT_VALUE_FONT_SIZE 18
-#define DEFAULT_CELL_PADDING 0
+#define JSON_DOCUMENT_CAPACITY 8192
+#define MEMORY_STATS_INTERVAL_FRAMES 100
+#define IDLE_BRIGHTNESS 16
+#define IDLE_REFRESH_PERIOD_MS 250
 
 DisplayManager::DisplayManager() 
     : lcd(), 
+      lcdMutex(nullptr),
       homeLabel(nullptr),
-      CPUGridLabelFontSize(DEFAULT_LABEL_FONT_SIZE),
-      CPUGridValueFontSize(DEFAULT_VALUE_FONT_SIZE),
-      OtherGridLabelFontSize(DEFAULT_LABEL_FONT_SIZE),
-      OtherGridValueFontSize(DEFAULT_VALUE_FONT_SIZE),
-      CPUGridCellPadding(DEFAULT_CELL_PADDING),
-      OtherGridCellPadding(DEFAULT_CELL_PADDING),
-      CPUGridRows(3),
-      CPUGridCols(4),
-      OtherGridRows(3),
-      OtherGridCols(3),
+      model(),
+      config(model.config),
+      alertEngine(model.alertEngine),
       currentLogLevel(LOG_LEVEL_INFO),  // Default log level
       screenCreated(false),
-      textColor(lv_color_white()) { // Default text color
+      frameCount(0),
+      idle(false),
+      activeBrightness(0),
+      jsonDoc(nullptr),
+      snapshotManager(nullptr),
+      staleLabel(nullptr),
+      sensorCollection(model.sensorCollection),
+      cpuCollection(model.cpuCollection),
+      otherCollection(model.otherCollection),
+      barChart(nullptr),
+      barSeries(nullptr),
+      chartPointCount(0),
+      arcPane(nullptr),
+      arcPage(0),
+      arcPageTimer(nullptr) {
+    cpuGridView.setAlertEngine(&alertEngine);
+    otherGridView.setAlertEngine(&alertEngine);
+    tweener.setChartInvalidator([this](size_t first, size_t last) { invalidateChartPoints(first, last); });
+    model.setSourceDropHandler([this](const String& source) {
+        logMessage(LOG_LEVEL_INFO, ("Dropping sensors of source: " + source).c_str());
+    });
 }
 
 void DisplayManager::init() {
     lcd.begin();
     lcd.setColorDepth(16);
     lcd.setRotation(2); // Adjust the rotation as needed (0, 1, 2, 3)
+    lcdMutex = xSemaphoreCreateMutex();
+
+    // The document pool lives in PSRAM and is reused for every frame
+    jsonDoc = new PsramJsonDocument(JSON_DOCUMENT_CAPACITY);
 
     // Initialize LVGL
     lv_init();
     static lv_disp_draw_buf_t draw_buf;
-    static lv_color_t buf[800 * 10]; // Updated to match the width of the screen
-    lv_disp_draw_buf_init(&draw_buf, buf, NULL, 800 * 10);
+    lv_color_t* buf1 = allocateDrawBuffer();
+    if (buf1 == NULL) {
+        // LVGL cannot render without a draw buffer, stop here instead of crashing on the first flush
+        logMessage(LOG_LEVEL_ERROR, "Fatal: no memory for the LVGL draw buffer, halting");
+        while (true) {
+            delay(1000);
+        }
+    }
+    lv_color_t* buf2 = ActiveDisplayProfile::bufferCount == 2 ? allocateDrawBuffer() : NULL;
+    if (ActiveDisplayProfile::bufferCount == 2 && buf2 == NULL) {
+        logMessage(LOG_LEVEL_WARN, "Second draw buffer unavailable, falling back to single buffering");
+    }
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, ActiveDisplayProfile::bufferPixels);
 
     static lv_disp_drv_t disp_drv;
     lv_disp_drv_init(&disp_drv);
-    disp_drv.hor_res = 800;
-    disp_drv.ver_res = 480;
+    disp_drv.hor_res = ActiveDisplayProfile::width;
+    disp_drv.ver_res = ActiveDisplayProfile::height;
     disp_drv.flush_cb = my_disp_flush;
     disp_drv.draw_buf = &draw_buf;
     disp_drv.user_data = this; // Pass the instance
     lv_disp_drv_register(&disp_drv);
 
+    // Shared label styles, restyled in place when fonts or TextColor change
+    lv_style_init(&cpuLabelStyle);
+    lv_style_init(&otherLabelStyle);
+    lv_style_init(&otherValueStyle);
+    applyStyles();
+    tweener.setFrameRate(config.tweenFps);
+
     createHomeScreen();
 }
 
+lv_color_t* DisplayManager::allocateDrawBuffer() {
+    const uint32_t psramCaps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+    const uint32_t sramCaps = MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+    bool preferPsram = ActiveDisplayProfile::placement == DRAW_BUFFER_PSRAM;
+    lv_color_t* buffer = (lv_color_t*)heap_caps_malloc(ActiveDisplayProfile::bufferBytes, preferPsram ? psramCaps : sramCaps);
+    if (buffer == nullptr) {
+        // Slower, or tighter on internal SRAM, but still renders
+        logMessage(LOG_LEVEL_WARN, preferPsram ? "Draw buffer does not fit in PSRAM, trying internal SRAM"
+                                               : "Draw buffer does not fit in internal SRAM, trying PSRAM");
+        buffer = (lv_color_t*)heap_caps_malloc(ActiveDisplayProfile::bufferBytes, preferPsram ? sramCaps : psramCaps);
+    }
+    if (buffer == nullptr) {
+        logMessage(LOG_LEVEL_ERROR, "Failed to allocate LVGL draw buffer");
+    }
+    return buffer;
+}
+
 void DisplayManager::my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
     DisplayManager* instance = (DisplayManager*)disp->user_data;
     if (instance != nullptr) {
+        xSemaphoreTake(instance->lcdMutex, portMAX_DELAY);
         instance->lcd.startWrite();
         instance->lcd.setAddrWindow(area->x1, area->y1, area->x2 - area->x1 + 1, area->y2 - area->y1 + 1);
         instance->lcd.pushColors(&color_p->full, (area->x2 - area->x1 + 1) * (area->y2 - area->y1 + 1), true);
         instance->lcd.endWrite();
+        xSemaphoreGive(instance->lcdMutex);
     }
     lv_disp_flush_ready(disp);
 }
 
+int DisplayManager::screenWidth() {
+    return lcd.width();
+}
+
+int DisplayManager::screenHeight() {
+    return lcd.height();
+}
+
+void DisplayManager::readScreenRow(int y, uint16_t* row) {
+    // The lock is held for one row only, so flushes are never held up for a whole image
+    xSemaphoreTake(lcdMutex, portMAX_DELAY);
+    lcd.readRect(0, y, lcd.width(), 1, (lgfx::rgb565_t*)row);
+    xSemaphoreGive(lcdMutex);
+}
+
 void DisplayManager::createHomeScreen() {
     lv_obj_t *scr = lv_scr_act();
     lv_obj_set_style_bg_color(scr, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT); // Set background to black
@@ -82,8 +155,36 @@ void DisplayManager::setLogLevel(LogLevel level) {
     currentLogLevel = level;
 }
 
-void DisplayManager::handleIncomingData(const String& json) {
-    DynamicJsonDocument doc(8192);
+void DisplayManager::setIdle(bool enable) {
+    if (enable == idle) {
+        return;
+    }
+    idle = enable;
+
+    lv_disp_t* disp = lv_disp_get_default();
+    if (idle) {
+        activeBrightness = lcd.getBrightness();
+        lcd.setBrightness(IDLE_BRIGHTNESS);
+        if (disp != nullptr) {
+            lv_timer_set_period(disp->refr_timer, IDLE_REFRESH_PERIOD_MS);
+        }
+        logMessage(LOG_LEVEL_INFO, "No data received, entering idle mode");
+    } else {
+        lcd.setBrightness(activeBrightness);
+        if (disp != nullptr) {
+            lv_timer_set_period(disp->refr_timer, LV_DISP_DEF_REFR_PERIOD);
+        }
+        logMessage(LOG_LEVEL_INFO, "Data received, leaving idle mode");
+    }
+}
+
+void DisplayManager::handleIncomingData(const String& source, const String& json) {
+    if (jsonDoc == nullptr) {
+        logMessage(LOG_LEVEL_ERROR, "handleIncomingData() called before init()");
+        return;
+    }
+
+    PsramJsonDocument& doc = *jsonDoc;
     DeserializationError error = deserializeJson(doc, json);
 
     if (error) {
@@ -92,175 +193,119 @@ void DisplayManager::handleIncomingData(const String& json) {
         return;
     }
 
-    if (doc["metadata"]["CustomMetadata"].containsKey("DebugLevel")) {
-        int debugLevel = doc["metadata"]["CustomMetadata"]["DebugLevel"].as<int>();
-        setLogLevel(static_cast<LogLevel>(debugLevel));
-    }
+    bool layoutChanged = applyFrame(source, doc);
+    setStale(false);
 
-    String layout = doc["metadata"]["CustomMetadata"]["Layout"].as<String>();
-    logMessage(LOG_LEVEL_INFO, ("Layout: " + layout).c_str());
+    // The snapshot holds every source's sensors, with the layout from whichever source sends it
+    if (snapshotManager != nullptr) {
+        JsonObjectConst metadata = doc["metadata"]["CustomMetadata"];
+        if (!metadata.isNull()) {
+            snapshotManager->setMetadata(metadata);
+        }
+        snapshotManager->record(model.sourceSensors, layoutChanged);
+    }
+}
 
-    // Initialize variables with values
-    int cpuGridLabelFontSize = CPUGridLabelFontSize;
-    int cpuGridValueFontSize = CPUGridValueFontSize;
-    int otherGridLabelFontSize = OtherGridLabelFontSize;
-    int otherGridValueFontSize = OtherGridValueFontSize;
-    int cpuGridCellPadding = CPUGridCellPadding;
-    int otherGridCellPadding = OtherGridCellPadding;
-    int cpuGridRows = CPUGridRows;
-    int cpuGridCols = CPUGridCols;
-    int otherGridRows = OtherGridRows;
-    int otherGridCols = OtherGridCols;
+void DisplayManager::setSnapshotManager(SnapshotManager* manager) {
+    snapshotManager = manager;
+}
 
-    // Update variables only if they are present in the JSON
-    if (doc["metadata"]["CustomMetadata"].containsKey("CPUGridLabelFontSize")) {
-        cpuGridLabelFontSize = doc["metadata"]["CustomMetadata"]["CPUGridLabelFontSize"].as<int>();
+bool DisplayManager::restoreSnapshot() {
+    if (snapshotManager == nullptr || jsonDoc == nullptr) {
+        return false;
     }
-    if (doc["metadata"]["CustomMetadata"].containsKey("CPUGridValueFontSize")) {
-        cpuGridValueFontSize = doc["metadata"]["CustomMetadata"]["CPUGridValueFontSize"].as<int>();
-    }
-    if (doc["metadata"]["CustomMetadata"].containsKey("OtherGridLabelFontSize")) {
-        otherGridLabelFontSize = doc["metadata"]["CustomMetadata"]["OtherGridLabelFontSize"].as<int>();
-    }
-    if (doc["metadata"]["CustomMetadata"].containsKey("OtherGridValueFontSize")) {
-        otherGridValueFontSize = doc["metadata"]["CustomMetadata"]["OtherGridValueFontSize"].as<int>();
-    }
-    if (doc["metadata"]["CustomMetadata"].containsKey("CPUGridCellPadding")) {
-        cpuGridCellPadding = doc["metadata"]["CustomMetadata"]["CPUGridCellPadding"].as<int>();
-    }
-    if (doc["metadata"]["CustomMetadata"].containsKey("OtherGridCellPadding")) {
-        otherGridCellPadding = doc["metadata"]["CustomMetadata"]["OtherGridCellPadding"].as<int>();
+
+    if (!snapshotManager->load(*jsonDoc)) {
+        logMessage(LOG_LEVEL_INFO, "No snapshot to restore");
+        return false;
     }
-    if (doc["metadata"]["CustomMetadata"].containsKey("CPUGridRows")) {
-        cpuGridRows = doc["metadata"]["CustomMetadata"]["CPUGridRows"].as<int>();
-        if (cpuGridRows == 0) {
-            cpuGridRows = 1; // Avoid division by zero
+
+    logMessage(LOG_LEVEL_INFO, "Restoring dashboard from snapshot");
+    applyFrame(SNAPSHOT_SOURCE, *jsonDoc);
+    setStale(true);
+    return true;
+}
+
+void DisplayManager::setStale(bool stale) {
+    if (!stale) {
+        if (staleLabel != nullptr) {
+            lv_obj_add_flag(staleLabel, LV_OBJ_FLAG_HIDDEN);
         }
+        return;
     }
-    if (doc["metadata"]["CustomMetadata"].containsKey("CPUGridCols")) {
-        cpuGridCols = doc["metadata"]["CustomMetadata"]["CPUGridCols"].as<int>();
-        if (cpuGridCols == 0) {
-            cpuGridCols = 1; // Avoid division by zero
+
+    // Lives on the top layer so it survives screen rebuilds
+    if (staleLabel == nullptr) {
+        staleLabel = lv_label_create(lv_layer_top());
+        if (staleLabel == nullptr) {
+            logMessage(LOG_LEVEL_ERROR, "Failed to create staleLabel");
+            return;
         }
+        lv_label_set_text(staleLabel, "Waiting for data");
+        lv_obj_set_style_text_color(staleLabel, lv_color_make(0xFF, 0xFF, 0x00), 0); // Yellow color
+        lv_obj_set_style_text_font(staleLabel, &lv_font_montserrat_14, 0);
+        lv_obj_align(staleLabel, LV_ALIGN_TOP_RIGHT, -4, 4);
     }
-    if (doc["metadata"]["CustomMetadata"].containsKey("OtherGridRows")) {
-        otherGridRows = doc["metadata"]["CustomMetadata"]["OtherGridRows"].as<int>();
-        if (otherGridRows == 0) {
-            otherGridRows = 1; // Avoid division by zero
+    lv_obj_clear_flag(staleLabel, LV_OBJ_FLAG_HIDDEN);
+}
+
+bool DisplayManager::applyFrame(const String& source, JsonDocument& doc) {
+    FrameChanges changes = model.apply(source, doc);
+    if (changes.configParsed) {
+        if (config.debugLevel >= 0) {
+            setLogLevel(static_cast<LogLevel>(config.debugLevel));
         }
+        tweener.setFrameRate(config.tweenFps);
     }
-    if (doc["metadata"]["CustomMetadata"].containsKey("OtherGridCols")) {
-        otherGridCols = doc["metadata"]["CustomMetadata"]["OtherGridCols"].as<int>();
-        if (otherGridCols == 0) {
-            otherGridCols = 1; // Avoid division by zero
-        }
+    if (changes.style) {
+        applyStyles();
     }
-
-    // Parse text color
-    if (doc["metadata"]["CustomMetadata"].containsKey("TextColor")) {
-        String textColorStr = doc["metadata"]["CustomMetadata"]["TextColor"].as<String>();
-        if (textColorStr.startsWith("#")) {
-            textColorStr.remove(0, 1); // Remove the '#' character if present
-        }
-        uint32_t colorValue = (uint32_t)strtol(textColorStr.c_str(), NULL, 16);
-        textColor = lv_color_hex(colorValue);
-    } else {
-        textColor = lv_color_white(); // Default color
-    }
-
-    // Check if metadata has changed
-    bool metadataChanged = cpuGridLabelFontSize != CPUGridLabelFontSize ||
-                           cpuGridValueFontSize != CPUGridValueFontSize ||
-                           otherGridLabelFontSize != OtherGridLabelFontSize ||
-                           otherGridValueFontSize != OtherGridValueFontSize ||
-                           cpuGridCellPadding != CPUGridCellPadding ||
-                           otherGridCellPadding != OtherGridCellPadding ||
-                           cpuGridRows != CPUGridRows ||
-                           cpuGridCols != CPUGridCols ||
-                           otherGridRows != OtherGridRows ||
-                           otherGridCols != OtherGridCols;
-
-    // Clear previous sensor data
-    sensorCollection.clear();
-    cpuCollection.clear();
-    otherCollection.clear();
-
-    // Parse sensor data
-    for (JsonPair kv : doc["sensors"].as<JsonObject>()) {
-        String sensorTag = kv.key().c_str();
-        JsonArray sensorDataArray = kv.value().as<JsonArray>();
-        String unit = sensorDataArray[0]["Unit"].as<String>();
-        String value = sensorDataArray[0]["Value"].as<String>();
-        int sensorOrder = sensorDataArray[0]["SensorOrder"].as<int>();
-        String category = sensorDataArray[0]["Category"].as<String>();
-        String componentName = sensorDataArray[0]["ComponentName"].as<String>();
-
-        SensorData sensorData = {sensorTag, value + " " + unit, sensorOrder, category, componentName};
-
-        if (layout == "DataGrid") {
-            sensorCollection.push_back(sensorData);
-        } else if (layout == "CPUDash" || layout == "CPUDials") {
-            if (category == "Load" && componentName == "CPU") {
-                cpuCollection.push_back(sensorData);
-            } else {
-                otherCollection.push_back(sensorData);
-            }
-        }
+    if (changes.alertRules) {
+        refreshAlertTargets();
     }
+    bool layoutChanged = !screenCreated || changes.structure;
 
-    auto compare = [](const SensorData& a, const SensorData& b) {
-        return a.order < b.order;
-    };
-
-    if (layout == "DataGrid") {
+    if (config.layout == LAYOUT_DATA_GRID) {
         logMessage(LOG_LEVEL_INFO, "Creating DataGrid Layout");
-        if (!screenCreated || metadataChanged) {
+        if (layoutChanged) {
             createDataGridScreen();
         }
         updateDataGridScreen();
-    } else if (layout == "CPUDash") {
-        std::sort(cpuCollection.begin(), cpuCollection.end(), compare);
-        std::sort(otherCollection.begin(), otherCollection.end(), compare);
+    } else if (config.layout == LAYOUT_CPU_DASH) {
         logMessage(LOG_LEVEL_INFO, "Creating CPUDash Layout");
-        if (!screenCreated || metadataChanged) {
+        if (layoutChanged) {
             createCPUDashScreen();
         }
         updateCPUDashScreen();
-    } else if (layout == "CPUDials") {
-        std::sort(cpuCollection.begin(), cpuCollection.end(), compare);
-        std::sort(otherCollection.begin(), otherCollection.end(), compare);
+    } else if (config.layout == LAYOUT_CPU_DIALS) {
         logMessage(LOG_LEVEL_INFO, "Creating CPUDials Layout");
-        if (!screenCreated || metadataChanged) {
+        if (layoutChanged) {
             createCPUDialsScreen();
         }
         updateCPUDialsScreen();
     }
 
-    // Update previous metadata values
-    CPUGridLabelFontSize = cpuGridLabelFontSize;
-    CPUGridValueFontSize = cpuGridValueFontSize;
-    OtherGridLabelFontSize = otherGridLabelFontSize;
-    OtherGridValueFontSize = otherGridValueFontSize;
-    CPUGridCellPadding = cpuGridCellPadding;
-    OtherGridCellPadding = otherGridCellPadding;
-    CPUGridRows = cpuGridRows;
-    CPUGridCols = cpuGridCols;
-    OtherGridRows = otherGridRows;
-    OtherGridCols = otherGridCols;
-}
+    if (++frameCount % MEMORY_STATS_INTERVAL_FRAMES == 0 && currentLogLevel >= LOG_LEVEL_DEBUG) {
+        lvglPool.logStats();
+    }
 
+    return layoutChanged || changes.style;
+}
 
 void DisplayManager::createDataGridScreen() {
     lv_obj_t *scr = lv_scr_act();
+    resetScreenWidgets(); // Cached grid cells and tweened widgets are deleted with the screen
     lv_obj_clean(scr); // Clear previous screen
 
     grid = lv_obj_create(scr);
     lv_obj_set_size(grid, lv_pct(100), lv_pct(100));
     lv_obj_align(grid, LV_ALIGN_CENTER, 0, 0);
-    lv_obj_set_style_pad_all(grid, OtherGridCellPadding, 0);
+    lv_obj_set_style_pad_all(grid, config.otherGridCellPadding, 0);
     lv_obj_set_style_bg_color(grid, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_border_width(grid, 0, 0);
 
+    createOtherGridLayout(grid);
+
     screenCreated = true;
 }
 
@@ -269,11 +314,12 @@ void DisplayManager::updateDataGridScreen() {
         createDataGridScreen();
     }
 
-    updateOtherGridLayout(grid, sensorCollection, OtherGridRows, OtherGridCols, OtherGridLabelFontSize, OtherGridValueFontSize);
+    otherGridView.bind(sensorCollection);
 }
 
 void DisplayManager::createCPUDashScreen() {
     lv_obj_t *scr = lv_scr_act();
+    resetScreenWidgets(); // Cached grid cells and tweened widgets are deleted with the screen
     lv_obj_clean(scr); // Clear previous screen
 
     // Left half for CPU sensors
@@ -281,57 +327,50 @@ void DisplayManager::createCPUDashScreen() {
     lv_obj_set_size(leftHalf, lv_pct(50), lv_pct(100));
     lv_obj_align(leftHalf, LV_ALIGN_LEFT_MID, 0, 0);
     lv_obj_set_style_bg_color(leftHalf, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_all(leftHalf, CPUGridCellPadding, 0);
+    lv_obj_set_style_pad_all(leftHalf, config.cpuGridCellPadding, 0);
     lv_obj_set_style_border_width(leftHalf, 0, 0); // No border for the container
 
     // Add padding to the leftHalf container
-    lv_obj_set_style_pad_top(leftHalf, 10, 0); // Adjust the value as needed
-    lv_obj_set_style_pad_bottom(leftHalf, 10, 0); // Adjust the value as needed
-    lv_obj_set_style_pad_left(leftHalf, 10, 0); // Adjust the value as needed
-    lv_obj_set_style_pad_right(leftHalf, 10, 0); // Adjust the value as needed
-
-    // Bar chart for CPU usage
-    barChart = lv_chart_create(leftHalf);
-    lv_obj_set_size(barChart, lv_pct(100), lv_pct(48)); // Adjust height to leave space for padding
-    lv_obj_align(barChart, LV_ALIGN_TOP_MID, 0, 0);
-    lv_chart_set_type(barChart, LV_CHART_TYPE_BAR);
-    lv_chart_set_div_line_count(barChart, 0, 0);
-    lv_obj_set_style_bg_color(barChart, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_width(barChart, 0, 0); // Remove border from bar chart
-    barSeries = lv_chart_add_series(barChart, lv_color_white(), LV_CHART_AXIS_PRIMARY_Y);
+    lv_obj_set_style_pad_top(leftHalf, DASH_PANE_PADDING, 0); // Adjust the value as needed
+    lv_obj_set_style_pad_bottom(leftHalf, DASH_PANE_PADDING, 0); // Adjust the value as needed
+    lv_obj_set_style_pad_left(leftHalf, DASH_PANE_PADDING, 0); // Adjust the value as needed
+    lv_obj_set_style_pad_right(leftHalf, DASH_PANE_PADDING, 0); // Adjust the value as needed
+
+    // Chart for CPU usage
+    createCPUChart(leftHalf);
 
     // Grid for CPU sensor values
     cpuGrid = lv_obj_create(leftHalf);
-    lv_obj_set_size(cpuGrid, lv_pct(100), lv_pct(48)); // Adjust height to leave space for padding
+    lv_obj_set_size(cpuGrid, lv_pct(100), lv_pct(CPU_GRID_HEIGHT_PERCENT)); // Adjust height to leave space for padding
     lv_obj_align(cpuGrid, LV_ALIGN_BOTTOM_MID, 0, 0);
     lv_obj_set_style_bg_color(cpuGrid, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_all(cpuGrid, CPUGridCellPadding, 0);
+    lv_obj_set_style_pad_all(cpuGrid, config.cpuGridCellPadding, 0);
     lv_obj_set_style_border_width(cpuGrid, 0, 0); // No border for CPU grid
 
-    updateCPUGridLayout(cpuGrid, cpuCollection, CPUGridRows, CPUGridCols, CPUGridLabelFontSize, CPUGridValueFontSize);
+    createCPUGridLayout(cpuGrid);
 
     // Right half for other sensors
     lv_obj_t *rightHalf = lv_obj_create(scr);
     lv_obj_set_size(rightHalf, lv_pct(50), lv_pct(100));
     lv_obj_align(rightHalf, LV_ALIGN_RIGHT_MID, 0, 0);
     lv_obj_set_style_bg_color(rightHalf, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_all(rightHalf, OtherGridCellPadding, 0);
+    lv_obj_set_style_pad_all(rightHalf, config.otherGridCellPadding, 0);
     lv_obj_set_style_border_width(rightHalf, 0, 0); // No border for the container
 
     // Add padding to the rightHalf container
-    lv_obj_set_style_pad_top(rightHalf, 10, 0); // Adjust the value as needed
-    lv_obj_set_style_pad_bottom(rightHalf, 10, 0); // Adjust the value as needed
-    lv_obj_set_style_pad_left(rightHalf, 10, 0); // Adjust the value as needed
-    lv_obj_set_style_pad_right(rightHalf, 10, 0); // Adjust the value as needed
+    lv_obj_set_style_pad_top(rightHalf, DASH_PANE_PADDING, 0); // Adjust the value as needed
+    lv_obj_set_style_pad_bottom(rightHalf, DASH_PANE_PADDING, 0); // Adjust the value as needed
+    lv_obj_set_style_pad_left(rightHalf, DASH_PANE_PADDING, 0); // Adjust the value as needed
+    lv_obj_set_style_pad_right(rightHalf, DASH_PANE_PADDING, 0); // Adjust the value as needed
 
     otherGrid = lv_obj_create(rightHalf);
     lv_obj_set_size(otherGrid, lv_pct(100), lv_pct(100)); // Use full height of rightHalf
     lv_obj_align(otherGrid, LV_ALIGN_CENTER, 0, 0);
     lv_obj_set_style_bg_color(otherGrid, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_all(otherGrid, OtherGridCellPadding, 0);
+    lv_obj_set_style_pad_all(otherGrid, config.otherGridCellPadding, 0);
     lv_obj_set_style_border_width(otherGrid, 0, 0); // No border for other grid
 
-    createArcs(otherGrid, otherCollection, OtherGridRows, OtherGridCols);
+    createOtherGridLayout(otherGrid);
 
     screenCreated = true;
 }
@@ -341,20 +380,15 @@ void DisplayManager::updateCPUDashScreen() {
         createCPUDashScreen();
     }
 
-    if (barChart != nullptr && barSeries != nullptr) {
-        lv_chart_set_point_count(barChart, cpuCollection.size());
-        for (size_t i = 0; i < cpuCollection.size(); ++i) {
-            int cpuUsage = cpuCollection[i].value.toInt();
-            lv_chart_set_value_by_id(barChart, barSeries, i, cpuUsage);
-        }
-    }
+    updateCPUChart();
 
-    updateCPUGridLayout(cpuGrid, cpuCollection, CPUGridRows, CPUGridCols, CPUGridLabelFontSize, CPUGridValueFontSize);
-    updateOtherGridLayout(otherGrid, otherCollection, OtherGridRows, OtherGridCols, OtherGridLabelFontSize, OtherGridValueFontSize);
+    cpuGridView.bind(model.cpuGridSensors());
+    otherGridView.bind(otherCollection);
 }
 
 void DisplayManager::createCPUDialsScreen() {
     lv_obj_t *scr = lv_scr_act();
+    resetScreenWidgets(); // Cached grid cells and tweened widgets are deleted with the screen
     lv_obj_clean(scr); // Clear previous screen
 
     // Left half for CPU sensors
@@ -362,38 +396,31 @@ void DisplayManager::createCPUDialsScreen() {
     lv_obj_set_size(leftHalf, lv_pct(50), lv_pct(100));
     lv_obj_align(leftHalf, LV_ALIGN_LEFT_MID, 0, 0);
     lv_obj_set_style_bg_color(leftHalf, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_all(leftHalf, CPUGridCellPadding, 0);
+    lv_obj_set_style_pad_all(leftHalf, config.cpuGridCellPadding, 0);
     lv_obj_set_style_border_width(leftHalf, 0, 0); // No border for the container
 
-    // Bar chart for CPU usage
-    barChart = lv_chart_create(leftHalf);
-    lv_obj_set_size(barChart, lv_pct(100), lv_pct(48));
-    lv_obj_align(barChart, LV_ALIGN_TOP_MID, 0, 0);
-    lv_chart_set_type(barChart, LV_CHART_TYPE_BAR);
-    lv_chart_set_div_line_count(barChart, 0, 0);
-    lv_obj_set_style_bg_color(barChart, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_width(barChart, 0, 0);
-    barSeries = lv_chart_add_series(barChart, lv_color_white(), LV_CHART_AXIS_PRIMARY_Y);
+    // Chart for CPU usage
+    createCPUChart(leftHalf);
 
     // Grid for CPU sensor values
     cpuGrid = lv_obj_create(leftHalf);
-    lv_obj_set_size(cpuGrid, lv_pct(100), lv_pct(48));
+    lv_obj_set_size(cpuGrid, lv_pct(100), lv_pct(CPU_GRID_HEIGHT_PERCENT));
     lv_obj_align(cpuGrid, LV_ALIGN_BOTTOM_MID, 0, 0);
     lv_obj_set_style_bg_color(cpuGrid, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_all(cpuGrid, CPUGridCellPadding, 0);
+    lv_obj_set_style_pad_all(cpuGrid, config.cpuGridCellPadding, 0);
     lv_obj_set_style_border_width(cpuGrid, 0, 0);
 
-    updateCPUGridLayout(cpuGrid, cpuCollection, CPUGridRows, CPUGridCols, CPUGridLabelFontSize, CPUGridValueFontSize);
+    createCPUGridLayout(cpuGrid);
 
     // Right half for other sensors rendered as arcs
     lv_obj_t *rightHalf = lv_obj_create(scr);
     lv_obj_set_size(rightHalf, lv_pct(50), lv_pct(100));
     lv_obj_align(rightHalf, LV_ALIGN_RIGHT_MID, 0, 0);
     lv_obj_set_style_bg_color(rightHalf, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_all(rightHalf, OtherGridCellPadding, 0);
+    lv_obj_set_style_pad_all(rightHalf, config.otherGridCellPadding, 0);
     lv_obj_set_style_border_width(rightHalf, 0, 0);
 
-    createArcs(rightHalf, otherCollection, OtherGridRows, OtherGridCols);
+    createArcs(rightHalf, config.otherGridRows, config.otherGridCols);
 
     screenCreated = true;
 }
@@ -404,29 +431,154 @@ void DisplayManager::updateCPUDialsScreen() {
         createCPUDialsScreen();
     }
 
-    if (barChart != nullptr && barSeries != nullptr) {
+    updateCPUChart();
+
+    cpuGridView.bind(model.cpuGridSensors());
+    updateArcs(otherCollection, config.otherGridRows, config.otherGridCols);
+}
+
+void DisplayManager::createCPUChart(lv_obj_t* parent) {
+    barChart = lv_chart_create(parent);
+    lv_obj_set_size(barChart, lv_pct(100), lv_pct(CPU_GRID_HEIGHT_PERCENT)); // Adjust height to leave space for padding
+    lv_obj_align(barChart, LV_ALIGN_TOP_MID, 0, 0);
+    lv_chart_set_div_line_count(barChart, 0, 0);
+    lv_obj_set_style_bg_color(barChart, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(barChart, 0, 0); // Remove border from chart
+
+    barSeries = nullptr;
+    historySeries.clear();
+    chartPointCount = 0;
+
+    if (config.cpuChartHistory) {
+        // Rolling history: one line per core, series are added once the core count is known
+        lv_chart_set_type(barChart, LV_CHART_TYPE_LINE);
+        lv_chart_set_update_mode(barChart, LV_CHART_UPDATE_MODE_SHIFT);
+        lv_chart_set_point_count(barChart, config.cpuChartHistoryPoints);
+        lv_obj_set_style_size(barChart, 0, LV_PART_INDICATOR); // Hide point markers
+        chartPointCount = config.cpuChartHistoryPoints;
+    } else {
+        lv_chart_set_type(barChart, LV_CHART_TYPE_BAR);
+        barSeries = lv_chart_add_series(barChart, lv_color_white(), LV_CHART_AXIS_PRIMARY_Y);
+        lv_obj_add_event_cb(barChart, chartDrawEventCallback, LV_EVENT_DRAW_PART_BEGIN, this);
+    }
+}
+
+void DisplayManager::chartDrawEventCallback(lv_event_t* e) {
+    DisplayManager* instance = (DisplayManager*)lv_event_get_user_data(e);
+    lv_obj_draw_part_dsc_t* dsc = lv_event_get_draw_part_dsc(e);
+    if (instance == nullptr || dsc->part != LV_PART_ITEMS || dsc->rect_dsc == nullptr) {
+        return;
+    }
+
+    // Bars take their colour from the series, so alerting cores are recoloured while drawing
+    lv_color_t color;
+    if (dsc->id < instance->cpuCollection.size() &&
+        instance->alertEngine.colorFor(instance->cpuCollection[dsc->id].alertSlot, color)) {
+        dsc->rect_dsc->bg_color = color;
+    }
+}
+
+void DisplayManager::updateCPUChart() {
+    if (barChart == nullptr || cpuCollection.empty()) {
+        return;
+    }
+
+    if (config.cpuChartHistory) {
+        updateCPUHistoryChart();
+    } else {
+        updateCPUBarChart();
+    }
+}
+
+void DisplayManager::updateCPUBarChart() {
+    if (barSeries == nullptr) {
+        return;
+    }
+
+    // Only reallocate the series when the number of cores changes
+    if (cpuCollection.size() != chartPointCount) {
         lv_chart_set_point_count(barChart, cpuCollection.size());
+        chartPointCount = cpuCollection.size();
+        tweener.bindChart(lv_chart_get_y_array(barChart, barSeries), chartPointCount);
+    }
+
+    // The tweener eases the bars toward the new loads and invalidates them as they move
+    if (tweener.isEnabled()) {
+        for (size_t i = 0; i < chartPointCount; ++i) {
+            tweener.setBarTarget(i, cpuCollection[i].value.toInt());
+        }
+        return;
+    }
+
+    // Write straight into the series and track the span of bars that changed
+    lv_coord_t* values = lv_chart_get_y_array(barChart, barSeries);
+    size_t firstChanged = chartPointCount;
+    size_t lastChanged = 0;
+    for (size_t i = 0; i < chartPointCount; ++i) {
+        lv_coord_t cpuUsage = cpuCollection[i].value.toInt();
+        if (values[i] != cpuUsage) {
+            values[i] = cpuUsage;
+            if (firstChanged == chartPointCount) {
+                firstChanged = i;
+            }
+            lastChanged = i;
+        }
+    }
+
+    if (firstChanged < chartPointCount) {
+        invalidateChartPoints(firstChanged, lastChanged);
+    }
+}
+
+void DisplayManager::updateCPUHistoryChart() {
+    // Rebuild the series only when the number of cores changes
+    if (cpuCollection.size() != historySeries.size()) {
+        for (lv_chart_series_t* series : historySeries) {
+            lv_chart_remove_series(barChart, series);
+        }
+        historySeries.clear();
         for (size_t i = 0; i < cpuCollection.size(); ++i) {
-            int cpuUsage = cpuCollection[i].value.toInt();
-            lv_chart_set_value_by_id(barChart, barSeries, i, cpuUsage);
+            lv_color_t color = lv_palette_main(static_cast<lv_palette_t>(i % LV_PALETTE_LAST));
+            historySeries.push_back(lv_chart_add_series(barChart, color, LV_CHART_AXIS_PRIMARY_Y));
         }
     }
 
-    updateCPUGridLayout(cpuGrid, cpuCollection, CPUGridRows, CPUGridCols, CPUGridLabelFontSize, CPUGridValueFontSize);
-    updateArcs(otherCollection, OtherGridRows, OtherGridCols);
+    // Same as lv_chart_set_next_value, without invalidating the chart once per core
+    for (size_t i = 0; i < historySeries.size(); ++i) {
+        lv_chart_series_t* series = historySeries[i];
+        if (series == nullptr) {
+            continue;
+        }
+        series->y_points[series->start_point] = cpuCollection[i].value.toInt();
+        series->start_point = (series->start_point + 1) % chartPointCount;
+    }
+
+    lv_chart_refresh(barChart);
 }
 
-void DisplayManager::createArcs(lv_obj_t* parent, const std::vector<SensorData>& collection, int rows, int cols) {
+void DisplayManager::invalidateChartPoints(size_t first, size_t last) {
+    // Bars are laid out evenly over the content width, so the changed span maps to one column range
+    lv_area_t area;
+    lv_obj_get_content_coords(barChart, &area);
+    lv_coord_t width = lv_area_get_width(&area);
+    lv_coord_t x1 = area.x1 + (width * first) / chartPointCount;
+    lv_coord_t x2 = area.x1 + (width * (last + 1)) / chartPointCount;
+    area.x1 = x1 - 1;
+    area.x2 = x2 + 1;
+    lv_obj_invalidate_area(barChart, &area);
+}
+
+void DisplayManager::createArcs(lv_obj_t* parent, int rows, int cols) {
     logMessage(LOG_LEVEL_INFO, "Creating arcs for sensors...");
+    arcPane = parent;
 
     // Calculate grid dimensions
     lv_coord_t cell_width = lv_pct(100 / cols);
     lv_coord_t cell_height = lv_pct(100 / rows);
 
-    const lv_font_t* labelFont = getFontBySize(OtherGridLabelFontSize);
-    const lv_font_t* valueFont = getFontBySize(OtherGridValueFontSize);
-
-    for (size_t i = 0; i < collection.size(); ++i) {
+    // One cell per grid position; larger collections are paged through them like the sensor grids
+    size_t cellCount = rows * cols;
+    for (size_t i = 0; i < cellCount; ++i) {
         int row = i / cols;
         int col = i % cols;
 
@@ -434,158 +586,195 @@ void DisplayManager::createArcs(lv_obj_t* parent, const std::vector<SensorData>&
         lv_obj_set_size(cell, cell_width, cell_height);
         lv_obj_align(cell, LV_ALIGN_TOP_LEFT, col * cell_width, row * cell_height);
         lv_obj_set_style_bg_color(cell, lv_color_black(), 0);
-        lv_obj_set_style_pad_all(cell, OtherGridCellPadding, 0);
+        lv_obj_set_style_pad_all(cell, config.otherGridCellPadding, 0);
         lv_obj_set_style_border_width(cell, 0, 0);
-
-        const auto& sensor = collection[i];
+        lv_obj_add_flag(cell, LV_OBJ_FLAG_HIDDEN); // Shown once a sensor is bound
 
         lv_obj_t* arc = lv_arc_create(cell);
         lv_obj_set_size(arc, lv_pct(80), lv_pct(80)); // Adjust the arc size to fit within the cell
         lv_arc_set_rotation(arc, 135);
         lv_arc_set_bg_angles(arc, 0, 270);
         lv_arc_set_range(arc, 0, 100); // Set arc range to 0-100
-        lv_arc_set_value(arc, sensor.value.toInt()); // Set the sensor value
         lv_obj_center(arc);
 
         lv_obj_t* label = lv_label_create(cell);
-        lv_label_set_text(label, sensor.tag.c_str());
-        lv_obj_set_style_text_color(label, textColor, 0);
-        lv_obj_set_style_text_font(label, labelFont, 0);
+        lv_label_set_text_static(label, "");
+        lv_obj_add_style(label, &otherLabelStyle, 0);
         lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, 0);
 
         lv_obj_t* valueLabel = lv_label_create(cell);
-        lv_label_set_text_fmt(valueLabel, "%s", sensor.value.c_str());
-        lv_obj_set_style_text_color(valueLabel, textColor, 0);
-        lv_obj_set_style_text_font(valueLabel, valueFont, 0);
+        lv_label_set_text_static(valueLabel, "");
+        lv_obj_add_style(valueLabel, &otherValueStyle, 0);
         lv_obj_align(valueLabel, LV_ALIGN_CENTER, 0, 0);
 
-        logMessage(LOG_LEVEL_INFO, ("Arc created for sensor: " + sensor.tag).c_str());
+        lv_obj_set_user_data(cell, nullptr); // Alert style currently applied to the arc
+    }
+
+    // Same page settings as the "other" grid the arcs replace
+    arcPage = config.otherGridPage >= 0 ? config.otherGridPage : 0; // Clamped on the next update
+    if (config.otherGridPage < 0 && config.gridPageInterval > 0) {
+        arcPageTimer = lv_timer_create(arcPageTimerCallback, config.gridPageInterval, this);
     }
 }
 
 void DisplayManager::updateArcs(const std::vector<SensorData>& collection, int rows, int cols) {
-    int itemIndex = 0;
     logMessage(LOG_LEVEL_INFO, "Updating arcs for sensors...");
-    lv_obj_t* parent = lv_obj_get_child(lv_scr_act(), 1); // Get the rightHalf container
-    for (size_t i = 0; i < collection.size(); ++i) {
-        int row = i / cols;
-        int col = i % cols;
-
-        lv_obj_t* cell = lv_obj_get_child(parent, itemIndex);
-        if (cell) {
-            lv_obj_t* arc = lv_obj_get_child(cell, 0);
-            if (arc && lv_obj_check_type(arc, &lv_arc_class)) {
-                lv_arc_set_value(arc, collection[i].value.toInt()); // Set the sensor value
-            }
-
-            lv_obj_t* label = lv_obj_get_child(cell, 1);
-            if (label && lv_obj_check_type(label, &lv_label_class)) {
-                lv_label_set_text(label, collection[i].tag.c_str());
-                lv_obj_set_style_text_font(label, getFontBySize(OtherGridLabelFontSize), 0);
-            }
+    if (arcPane == nullptr) {
+        return;
+    }
 
-            lv_obj_t* valueLabel = lv_obj_get_child(cell, 2);
-            if (valueLabel && lv_obj_check_type(valueLabel, &lv_label_class)) {
-                lv_label_set_text_fmt(valueLabel, "%s", collection[i].value.c_str());
-                lv_obj_set_style_text_font(valueLabel, getFontBySize(OtherGridValueFontSize), 0);
-            }
+    size_t cellCount = rows * cols;
+    if (arcPage >= arcPageCount()) {
+        arcPage = 0;
+        tweener.snapArcs(); // The collection shrank, the cells show other sensors now
+    }
+    if (arcTags.size() < cellCount) {
+        arcTags.resize(cellCount);
+    }
 
-            logMessage(LOG_LEVEL_INFO, ("Arc updated for sensor: " + collection[i].tag).c_str());
+    // Cells past the end of the collection on the last page are hidden
+    size_t first = arcPage * cellCount;
+    for (size_t i = 0; i < cellCount; ++i) {
+        lv_obj_t* cell = lv_obj_get_child(arcPane, i);
+        if (cell == nullptr) {
+            break;
         }
-        ++itemIndex;
-    }
-}
 
+        size_t sensorIndex = first + i;
+        if (sensorIndex >= collection.size()) {
+            lv_obj_add_flag(cell, LV_OBJ_FLAG_HIDDEN);
+            arcTags[i] = String();
+            continue;
+        }
 
+        // Arcs are tweened per cell, so a cell that now shows another sensor, e.g. after a Raise
+        // reordered the collection, jumps to it instead of sweeping from the previous sensor's value
+        const SensorData& sensor = collection[sensorIndex];
+        if (arcTags[i] != sensor.tag) {
+            tweener.snapArc(i);
+            arcTags[i] = sensor.tag;
+        }
 
+        lv_obj_t* arc = lv_obj_get_child(cell, 0);
+        if (arc && lv_obj_check_type(arc, &lv_arc_class)) {
+            if (tweener.isEnabled()) {
+                tweener.setArcTarget(i, arc, sensor.value.toInt()); // Starts settled at the first value
+            } else {
+                lv_arc_set_value(arc, sensor.value.toInt()); // Set the sensor value
+            }
+        }
 
+        lv_obj_t* label = lv_obj_get_child(cell, 1);
+        if (label && lv_obj_check_type(label, &lv_label_class)) {
+            lv_label_set_text(label, sensor.tag.c_str());
+        }
 
-void DisplayManager::updateCPUGridLayout(lv_obj_t* grid, const std::vector<SensorData>& collection, int rows, int cols, int labelFontSize, int valueFontSize) {
-    lv_obj_clean(grid); // Clear previous grid items
-    const lv_font_t* labelFont = getFontBySize(labelFontSize);
-    const lv_font_t* valueFont = getFontBySize(valueFontSize);
+        lv_obj_t* valueLabel = lv_obj_get_child(cell, 2);
+        if (valueLabel && lv_obj_check_type(valueLabel, &lv_label_class)) {
+            lv_label_set_text_fmt(valueLabel, "%s", sensor.value.c_str());
+        }
 
-    static lv_coord_t* col_dsc = new lv_coord_t[cols + 1];
-    static lv_coord_t* row_dsc = new lv_coord_t[rows + 1];
+        applyArcAlertStyle(cell, sensor.alertSlot);
+        lv_obj_clear_flag(cell, LV_OBJ_FLAG_HIDDEN);
 
-    for (int i = 0; i < cols; i++) {
-        col_dsc[i] = LV_GRID_FR(1);
+        logMessage(LOG_LEVEL_INFO, ("Arc updated for sensor: " + sensor.tag).c_str());
     }
-    col_dsc[cols] = LV_GRID_TEMPLATE_LAST;
+}
 
-    for (int i = 0; i < rows; i++) {
-        row_dsc[i] = LV_GRID_FR(1);
+size_t DisplayManager::arcPageCount() const {
+    size_t cellCount = config.otherGridRows * config.otherGridCols;
+    if (cellCount == 0 || otherCollection.empty()) {
+        return 1;
     }
-    row_dsc[rows] = LV_GRID_TEMPLATE_LAST;
-
-    lv_obj_set_grid_dsc_array(grid, col_dsc, row_dsc);
-
-    int itemIndex = 0;
-    for (const auto& sensor : collection) {
-        int row = itemIndex / cols;
-        int col = itemIndex % cols;
+    return (otherCollection.size() + cellCount - 1) / cellCount;
+}
 
-        lv_obj_t* cell = lv_obj_create(grid);
-        lv_obj_set_grid_cell(cell, LV_GRID_ALIGN_STRETCH, col, 1, LV_GRID_ALIGN_STRETCH, row, 1);
-        lv_obj_set_style_bg_color(cell, lv_color_black(), 0);
-        lv_obj_set_style_pad_all(cell, CPUGridCellPadding, 0);
-        lv_obj_set_style_border_color(cell, lv_color_black(), 0); // Set border color to black
-        lv_obj_set_style_border_width(cell, 1, 0); // Set border width
-        lv_obj_set_scrollbar_mode(cell, LV_SCROLLBAR_MODE_OFF); // Disable scrollbars
+void DisplayManager::arcPageTimerCallback(lv_timer_t* timer) {
+    DisplayManager* instance = (DisplayManager*)timer->user_data;
+    size_t pages = instance->arcPageCount();
+    if (instance->arcPane == nullptr || pages <= 1) {
+        return;
+    }
+    instance->arcPage = (instance->arcPage + 1) % pages;
+    instance->tweener.snapArcs(); // Dials jump to the new sensors instead of sweeping from the old ones
+    instance->updateArcs(instance->otherCollection, instance->config.otherGridRows, instance->config.otherGridCols);
+}
 
-        lv_obj_t* label = lv_label_create(cell);
-        lv_label_set_text_fmt(label, "%s\n%s", sensor.tag.c_str(), sensor.value.c_str());
-        lv_obj_set_style_text_font(label, labelFont, 0);
-        lv_obj_set_style_text_color(label, textColor, 0); // Apply text color
-        lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0); // Center text alignment
-        lv_obj_align(label, LV_ALIGN_CENTER, 0, 0); // Center the label within the cell
+void DisplayManager::applyArcAlertStyle(lv_obj_t* cell, uint16_t alertSlot) {
+    lv_style_t* applied = (lv_style_t*)lv_obj_get_user_data(cell);
+    lv_style_t* wanted = alertEngine.styleFor(alertSlot);
+    if (applied == wanted) {
+        return;
+    }
 
-        ++itemIndex;
+    lv_obj_t* arc = lv_obj_get_child(cell, 0);
+    lv_obj_t* valueLabel = lv_obj_get_child(cell, 2);
+    if (applied != nullptr) {
+        lv_obj_remove_style(arc, applied, LV_PART_INDICATOR);
+        lv_obj_remove_style(valueLabel, applied, 0);
+    }
+    if (wanted != nullptr) {
+        lv_obj_add_style(arc, wanted, LV_PART_INDICATOR);
+        lv_obj_add_style(valueLabel, wanted, 0);
     }
+    lv_obj_set_user_data(cell, wanted);
 }
 
-void DisplayManager::updateOtherGridLayout(lv_obj_t* grid, const std::vector<SensorData>& collection, int rows, int cols, int labelFontSize, int valueFontSize) {
-    lv_obj_clean(grid); // Clear previous grid items
-    const lv_font_t* labelFont = getFontBySize(labelFontSize);
-    const lv_font_t* valueFont = getFontBySize(valueFontSize);
+void DisplayManager::createCPUGridLayout(lv_obj_t* grid) {
+    cpuGridView.build(grid, config.cpuGridRows, config.cpuGridCols, config.cpuGridCellPadding, &cpuLabelStyle);
+    cpuGridView.setPaging(-1, config.gridPageInterval);
+}
 
-    static lv_coord_t* col_dsc = new lv_coord_t[cols + 1];
-    static lv_coord_t* row_dsc = new lv_coord_t[rows + 1];
+void DisplayManager::createOtherGridLayout(lv_obj_t* grid) {
+    otherGridView.build(grid, config.otherGridRows, config.otherGridCols, config.otherGridCellPadding, &otherLabelStyle);
+    otherGridView.setPaging(config.otherGridPage, config.gridPageInterval);
+}
 
-    for (int i = 0; i < cols; i++) {
-        col_dsc[i] = LV_GRID_FR(1);
+void DisplayManager::resetScreenWidgets() {
+    cpuGridView.reset();
+    otherGridView.reset();
+    tweener.clear();
+    barChart = nullptr;
+    barSeries = nullptr;
+    historySeries.clear();
+    chartPointCount = 0;
+    arcPane = nullptr;
+    arcPage = 0;
+    arcTags.clear();
+    if (arcPageTimer != nullptr) {
+        lv_timer_del(arcPageTimer);
+        arcPageTimer = nullptr;
     }
-    col_dsc[cols] = LV_GRID_TEMPLATE_LAST;
+}
 
-    for (int i = 0; i < rows; i++) {
-        row_dsc[i] = LV_GRID_FR(1);
+void DisplayManager::refreshAlertTargets() {
+    // Slots were reset, so cached style pointers and bar colours no longer say anything
+    cpuGridView.clearAlertStyles();
+    otherGridView.clearAlertStyles();
+    if (arcPane != nullptr) {
+        for (uint32_t i = 0; i < lv_obj_get_child_cnt(arcPane); ++i) {
+            applyArcAlertStyle(lv_obj_get_child(arcPane, i), ALERT_NO_SLOT);
+        }
     }
-    row_dsc[rows] = LV_GRID_TEMPLATE_LAST;
-
-    lv_obj_set_grid_dsc_array(grid, col_dsc, row_dsc);
-
-    int itemIndex = 0;
-    for (const auto& sensor : collection) {
-        int row = itemIndex / cols;
-        int col = itemIndex % cols;
+    if (barChart != nullptr) {
+        lv_obj_invalidate(barChart); // Bars with unchanged values are not invalidated by the update
+    }
+}
 
-        lv_obj_t* cell = lv_obj_create(grid);
-        lv_obj_set_grid_cell(cell, LV_GRID_ALIGN_STRETCH, col, 1, LV_GRID_ALIGN_STRETCH, row, 1);
-        lv_obj_set_style_bg_color(cell, lv_color_black(), 0);
-        lv_obj_set_style_pad_all(cell, OtherGridCellPadding, 0);
-        lv_obj_set_style_border_color(cell, lv_color_black(), 0); // Set border color to black
-        lv_obj_set_style_border_width(cell, 1, 0); // Set border width
-        lv_obj_set_scrollbar_mode(cell, LV_SCROLLBAR_MODE_OFF); // Disable scrollbars
+void DisplayManager::applyStyles() {
+    lv_color_t textColor = lv_color_hex(config.textColor);
 
-        lv_obj_t* label = lv_label_create(cell);
-        lv_label_set_text_fmt(label, "%s\n%s", sensor.tag.c_str(), sensor.value.c_str());
-        lv_obj_set_style_text_font(label, labelFont, 0);
-        lv_obj_set_style_text_color(label, textColor, 0); // Apply text color
-        lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0); // Center text alignment
-        lv_obj_align(label, LV_ALIGN_CENTER, 0, 0); // Center the label within the cell
+    lv_style_set_text_color(&cpuLabelStyle, textColor);
+    lv_style_set_text_font(&cpuLabelStyle, getFontBySize(config.cpuGridLabelFontSize));
+    lv_style_set_text_color(&otherLabelStyle, textColor);
+    lv_style_set_text_font(&otherLabelStyle, getFontBySize(config.otherGridLabelFontSize));
+    lv_style_set_text_color(&otherValueStyle, textColor);
+    lv_style_set_text_font(&otherValueStyle, getFontBySize(config.otherGridValueFontSize));
 
-        ++itemIndex;
-    }
+    // Only the widgets using these styles are refreshed
+    lv_obj_report_style_change(&cpuLabelStyle);
+    lv_obj_report_style_change(&otherLabelStyle);
+    lv_obj_report_style_change(&otherValueStyle);
 }
 
 const lv_font_t* DisplayManager::getFontBySize(int fontSize) {
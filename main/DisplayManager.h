@@ -5,6 +5,11 @@
 #include <ArduinoJson.h>
 #include <vector>
 #include "LGFXSetup.h"
+#include "MemoryPool.h"
+#include "SnapshotManager.h"
+#include "SensorModel.h"
+#include "ValueTweener.h"
+#include "VirtualGrid.h"
 
 enum LogLevel {
     LOG_LEVEL_NONE = 0,
@@ -14,31 +19,30 @@ enum LogLevel {
     LOG_LEVEL_DEBUG
 };
 
-struct SensorData {
-    String tag;
-    String value;
-    int order;
-    String category;
-    String componentName;
-
-    bool operator<(const SensorData& other) const {
-        return order < other.order;
-    }
-};
-
 class DisplayManager {
 public:
     DisplayManager();
     virtual void init();
     void createHomeScreen();
-    virtual void handleIncomingData(const String& json);
+    virtual void handleIncomingData(const String& source, const String& json);
     void setLogLevel(LogLevel level);
     void logMessage(LogLevel level, const char* message);
+    void setIdle(bool idle); // Dims the backlight and slows the refresh rate while no data arrives
+    void setSnapshotManager(SnapshotManager* manager);
+    bool restoreSnapshot(); // Rebuilds the last dashboard from flash and marks it stale
+    int screenWidth();
+    int screenHeight();
+    void readScreenRow(int y, uint16_t* row); // RGB565 pixels of one framebuffer row, safe from any task
 
 protected:
     LGFX lcd;
+    SemaphoreHandle_t lcdMutex; // Serializes flushes with framebuffer reads from other tasks
     lv_obj_t* homeLabel;
     static void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p);
+    lv_color_t* allocateDrawBuffer(); // Sized and placed by ActiveDisplayProfile, falls back to the other memory
+
+    bool applyFrame(const String& source, JsonDocument& doc); // Returns true when the layout or its metadata changed
+    void setStale(bool stale);
 
     void createDataGridScreen();
     void updateDataGridScreen();
@@ -46,37 +50,59 @@ protected:
     void updateCPUDashScreen();
     void createCPUDialsScreen();      // New method for creating CPUDials layout
     void updateCPUDialsScreen();      // New method for updating CPUDials layout
-    void createArcs(lv_obj_t* parent, const std::vector<SensorData>& collection, int rows, int cols);  // New method for creating arcs
+    void createCPUChart(lv_obj_t* parent);   // Creates the CPU load chart in bar or history mode
+    void updateCPUChart();                   // Writes the latest CPU loads into the chart series
+    void updateCPUBarChart();
+    void updateCPUHistoryChart();
+    void invalidateChartPoints(size_t first, size_t last);
+    static void chartDrawEventCallback(lv_event_t* e); // Colours bars of alerting cores
+    void createArcs(lv_obj_t* parent, int rows, int cols);  // New method for creating arcs
     void updateArcs(const std::vector<SensorData>& collection, int rows, int cols);                    // New method for updating arcs
-    void updateCPUGridLayout(lv_obj_t* grid, const std::vector<SensorData>& collection, int rows, int cols, int labelFontSize, int valueFontSize);
-    void updateOtherGridLayout(lv_obj_t* grid, const std::vector<SensorData>& collection, int rows, int cols, int labelFontSize, int valueFontSize);
+    size_t arcPageCount() const;
+    static void arcPageTimerCallback(lv_timer_t* timer); // Rotates the arcs like the sensor grids
+    void applyArcAlertStyle(lv_obj_t* cell, uint16_t alertSlot);
+    void createCPUGridLayout(lv_obj_t* grid);
+    void createOtherGridLayout(lv_obj_t* grid);
+    void resetScreenWidgets(); // Drops grid, chart and tween state bound to widgets of the old screen
+    void refreshAlertTargets(); // Reapplies alert styles and colours after the rules were recompiled
+    void applyStyles(); // Pushes fonts and text color from config into the shared styles
     const lv_font_t* getFontBySize(int fontSize);
 
-    int CPUGridLabelFontSize;
-    int CPUGridValueFontSize;
-    int OtherGridLabelFontSize;
-    int OtherGridValueFontSize;
-    int CPUGridCellPadding;
-    int OtherGridCellPadding;
-    int CPUGridRows;
-    int CPUGridCols;
-    int OtherGridRows;
-    int OtherGridCols;
+    SensorModel model;
+    const LayoutConfig& config; // Shorthands for the model's state
+    const AlertEngine& alertEngine;
+    lv_style_t cpuLabelStyle;
+    lv_style_t otherLabelStyle;
+    lv_style_t otherValueStyle;
 
     bool screenCreated;
+    uint32_t frameCount;
+    bool idle;
+    uint8_t activeBrightness;
+    PsramJsonDocument* jsonDoc; // Reused for every frame, allocated once in init()
+    SnapshotManager* snapshotManager;
+    lv_obj_t* staleLabel;
 
     LogLevel currentLogLevel;
 
-    std::vector<SensorData> sensorCollection;
-    std::vector<SensorData> cpuCollection;
-    std::vector<SensorData> otherCollection;
+    const std::vector<SensorData>& sensorCollection;
+    const std::vector<SensorData>& cpuCollection; // Sensor order, the chart's bars and series follow it
+    const std::vector<SensorData>& otherCollection;
 
     lv_obj_t* barChart;
     lv_chart_series_t* barSeries;
+    std::vector<lv_chart_series_t*> historySeries; // One series per core in history mode
+    size_t chartPointCount; // Point count last applied to barChart
+    ValueTweener tweener;   // Eases arcs and bars toward the latest values
     lv_obj_t* otherGrid;
+    lv_obj_t* arcPane; // Parent of the CPUDials arc cells
+    size_t arcPage;    // Page of otherCollection shown by the arcs, paged like otherGridView
+    std::vector<String> arcTags; // Sensor shown by each arc cell, a different sensor snaps instead of easing
+    lv_timer_t* arcPageTimer;
     lv_obj_t* cpuGrid;
     lv_obj_t* grid;
-    lv_color_t textColor;
+    VirtualGrid cpuGridView;
+    VirtualGrid otherGridView;
 };
 
 #endif // DISPLAY_MANAGER_H
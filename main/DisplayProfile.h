@@ -0,0 +1,89 @@
+#ifndef DISPLAY_PROFILE_H
+#define DISPLAY_PROFILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <lvgl.h>
+
+// Compile-time description of the panel and LVGL draw buffers. Everything that depends on the
+// resolution or buffer geometry reads ActiveDisplayProfile, and the static asserts reject
+// configurations that do not fit the memory budget before they reach the device.
+//
+// Override from the build flags, e.g. -DDRAW_BUFFER_LINES=40 -DDRAW_BUFFER_COUNT=2
+// -DDRAW_BUFFER_IN_PSRAM=1.
+
+#ifndef DRAW_BUFFER_LINES
+#define DRAW_BUFFER_LINES 10
+#endif
+
+#ifndef DRAW_BUFFER_COUNT
+#define DRAW_BUFFER_COUNT 1
+#endif
+
+#ifndef DRAW_BUFFER_IN_PSRAM
+#define DRAW_BUFFER_IN_PSRAM 0
+#endif
+
+#define SRAM_DRAW_BUFFER_BUDGET (96 * 1024)    // Leaves internal SRAM for WiFi, LVGL objects and the pool
+#define PSRAM_DRAW_BUFFER_BUDGET (1024 * 1024)
+#define MIN_GRID_CELL_SIZE 40                  // Smallest cell that still fits a label in the smallest font
+#define DASH_PANE_PADDING 10                   // Inner padding of the dashboard halves
+#define CPU_GRID_HEIGHT_PERCENT 48             // Share of the left half given to the CPU grid, the chart takes the same
+
+enum DrawBufferPlacement {
+    DRAW_BUFFER_SRAM,
+    DRAW_BUFFER_PSRAM
+};
+
+// RGB bus timings of the Elecrow 7" ESP32-S3 panel
+struct CrowPanel7Timing {
+    static constexpr uint32_t pclkHz = 14000000;
+    static constexpr uint16_t hsyncFrontPorch = 40;
+    static constexpr uint16_t hsyncPulseWidth = 48;
+    static constexpr uint16_t hsyncBackPorch = 40;
+    static constexpr uint16_t vsyncFrontPorch = 1;
+    static constexpr uint16_t vsyncPulseWidth = 31;
+    static constexpr uint16_t vsyncBackPorch = 13;
+};
+
+template <uint16_t Width, uint16_t Height, typename Timing, uint16_t BufferLines, uint8_t BufferCount, DrawBufferPlacement Placement>
+struct DisplayProfile {
+    typedef Timing timing;
+
+    static constexpr uint16_t width = Width;
+    static constexpr uint16_t height = Height;
+    static constexpr uint16_t bufferLines = BufferLines;
+    static constexpr uint8_t bufferCount = BufferCount;
+    static constexpr DrawBufferPlacement placement = Placement;
+    static constexpr size_t bufferPixels = (size_t)Width * BufferLines;
+    static constexpr size_t bufferBytes = bufferPixels * sizeof(lv_color_t);
+    static constexpr size_t totalBufferBytes = bufferBytes * BufferCount;
+
+    // Grid limits per area, so cells never get smaller than MIN_GRID_CELL_SIZE:
+    // the data grid fills the screen, dashboard grids get one padded half, the CPU grid part of it
+    static constexpr uint16_t paneWidth = Width / 2 - 2 * DASH_PANE_PADDING;
+    static constexpr uint16_t paneHeight = Height - 2 * DASH_PANE_PADDING;
+    static constexpr uint16_t maxDataGridRows = Height / MIN_GRID_CELL_SIZE;
+    static constexpr uint16_t maxDataGridCols = Width / MIN_GRID_CELL_SIZE;
+    static constexpr uint16_t maxDashGridRows = paneHeight / MIN_GRID_CELL_SIZE;
+    static constexpr uint16_t maxDashGridCols = paneWidth / MIN_GRID_CELL_SIZE;
+    static constexpr uint16_t maxCpuGridRows = paneHeight * CPU_GRID_HEIGHT_PERCENT / 100 / MIN_GRID_CELL_SIZE;
+    static constexpr uint16_t maxCpuGridCols = paneWidth / MIN_GRID_CELL_SIZE;
+
+    static_assert(Width > 0 && Height > 0, "Display profile needs a resolution");
+    static_assert(BufferLines > 0 && BufferLines <= Height, "Draw buffer must hold between one line and the full screen");
+    static_assert(BufferCount == 1 || BufferCount == 2, "LVGL supports single or double draw buffers");
+    static_assert(Placement != DRAW_BUFFER_SRAM || totalBufferBytes <= SRAM_DRAW_BUFFER_BUDGET,
+                  "Draw buffers exceed the internal SRAM budget, use fewer lines or place them in PSRAM");
+    static_assert(Placement != DRAW_BUFFER_PSRAM || totalBufferBytes <= PSRAM_DRAW_BUFFER_BUDGET,
+                  "Draw buffers exceed the PSRAM budget");
+    static_assert(Width / 2 > 2 * DASH_PANE_PADDING && Height > 2 * DASH_PANE_PADDING, "Screen too small for the dashboard panes");
+    static_assert(maxCpuGridRows > 0 && maxCpuGridCols > 0, "Screen too small for a single CPU grid cell");
+};
+
+typedef DisplayProfile<800, 480, CrowPanel7Timing, DRAW_BUFFER_LINES, DRAW_BUFFER_COUNT,
+                       DRAW_BUFFER_IN_PSRAM ? DRAW_BUFFER_PSRAM : DRAW_BUFFER_SRAM> CrowPanel7Profile;
+
+typedef CrowPanel7Profile ActiveDisplayProfile;
+
+#endif // DISPLAY_PROFILE_H
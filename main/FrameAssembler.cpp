@@ -0,0 +1,58 @@
+#include "FrameAssembler.h"
+
+FrameAssembler::FrameAssembler()
+    : jsonBuffer(""), payloadLength(0), readingLength(true), bytesRead(0) {}
+
+bool FrameAssembler::feed(const uint8_t* data, size_t len) {
+    if (data == nullptr || len == 0) {
+        Serial.println("Error: Incoming data is null or empty.");
+        return false;
+    }
+
+    if (readingLength) {
+        // Check the first byte of the incoming data
+        char firstByte = data[0];
+        if (firstByte == '{') {
+            // If the data starts with '{', it indicates that there's no prefix length
+            Serial.println("Data without prefix length detected. Responding 'ok'.");
+            reset();
+            return false;
+        }
+
+        // If the first byte is a number, assume the data includes a length prefix
+        if (!isdigit(firstByte)) {
+            return false;
+        }
+        jsonBuffer.concat((const char*)data, len); // Chunks are not NUL-terminated
+        bytesRead += len;
+
+        if (jsonBuffer.length() < 8) {
+            return false;
+        }
+        payloadLength = jsonBuffer.substring(0, 8).toInt(); // Convert the length prefix to an integer
+        Serial.print("Length Prefix Detected: ");
+        Serial.println(payloadLength);
+        jsonBuffer = jsonBuffer.substring(8); // Remove the length prefix from the buffer
+        readingLength = false; // Switch to reading the payload
+        // Fall through: a single HTTP chunk often carries the prefix and the whole payload
+    } else {
+        // Append the data chunk to the buffer
+        jsonBuffer.concat((const char*)data, len); // Chunks are not NUL-terminated
+        bytesRead += len;
+    }
+
+    return bytesRead >= payloadLength && jsonBuffer.length() > 0;
+}
+
+String FrameAssembler::take() {
+    String frame = std::move(jsonBuffer);
+    reset();
+    return frame;
+}
+
+void FrameAssembler::reset() {
+    jsonBuffer = "";
+    payloadLength = 0;
+    readingLength = true;
+    bytesRead = 0;
+}
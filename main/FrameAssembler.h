@@ -0,0 +1,23 @@
+#ifndef FRAME_ASSEMBLER_H
+#define FRAME_ASSEMBLER_H
+
+#include <Arduino.h>
+
+// Reassembles one length-prefixed frame from chunks: an 8-digit length that counts the prefix
+// itself, then the JSON payload. Every connection and the serial port get their own assembler,
+// so concurrent senders can never interleave their bytes into one frame.
+class FrameAssembler {
+public:
+    FrameAssembler();
+    bool feed(const uint8_t* data, size_t len); // True once a frame is complete, fetch it with take()
+    String take();
+    void reset();
+
+private:
+    String jsonBuffer;
+    int payloadLength; // Length of the payload
+    bool readingLength; // Flag to check if reading the length
+    int bytesRead; // Bytes read so far
+};
+
+#endif // FRAME_ASSEMBLER_H
@@ -0,0 +1,142 @@
+#include "FrameCapture.h"
+
+#define RECORD_HEADER_SIZE 12
+
+static const uint8_t captureMagic[8] = {'J', 'R', 'C', 'A', 'P', '1', 0, 0};
+
+FrameCapture::FrameCapture()
+    : buffer(nullptr), capacity(0), head(0), tail(0), used(0),
+      recording(false), reading(false), droppedRecords(0) {}
+
+bool FrameCapture::begin(size_t size) {
+    if (reading) {
+        return false; // The download's response filler still reads from the buffer
+    }
+    if (size == 0 || size > FRAME_CAPTURE_MAX_SIZE) {
+        Serial.println("Error: Capture size out of range");
+        return false;
+    }
+    if (buffer == nullptr || capacity != size) {
+        free(buffer);
+        buffer = (uint8_t*)ps_malloc(size);
+        capacity = buffer != nullptr ? size : 0;
+    }
+    if (buffer == nullptr) {
+        Serial.println("Error: Failed to allocate capture buffer");
+        recording = false;
+        return false;
+    }
+    clear();
+    recording = true;
+    return true;
+}
+
+void FrameCapture::stop() {
+    recording = false;
+}
+
+void FrameCapture::clear() {
+    head = 0;
+    tail = 0;
+    used = 0;
+    droppedRecords = 0;
+}
+
+bool FrameCapture::isRecording() const {
+    return recording;
+}
+
+bool FrameCapture::isReading() const {
+    return reading;
+}
+
+void FrameCapture::record(const uint8_t* data, size_t len, uint16_t flags) {
+    if (!recording || buffer == nullptr) {
+        return;
+    }
+    if (reading) {
+        droppedRecords++; // Paused while a download runs
+        return;
+    }
+
+    size_t recordSize = RECORD_HEADER_SIZE + len;
+    if (recordSize > capacity) {
+        droppedRecords++;
+        return;
+    }
+    while (capacity - used < recordSize) {
+        dropOldest();
+    }
+
+    uint8_t header[RECORD_HEADER_SIZE];
+    uint32_t timestamp = millis();
+    uint32_t length = len;
+    memcpy(header, &timestamp, 4); // ESP32 is little-endian, matching the file format
+    memcpy(header + 4, &flags, 2);
+    memset(header + 6, 0, 2);
+    memcpy(header + 8, &length, 4);
+    writeBytes(header, RECORD_HEADER_SIZE);
+    writeBytes(data, len);
+}
+
+size_t FrameCapture::beginRead() {
+    reading = true; // Recording pauses so the download stays consistent
+    return sizeof(captureMagic) + used;
+}
+
+size_t FrameCapture::read(uint8_t* out, size_t maxLen, size_t offset) {
+    size_t total = sizeof(captureMagic) + used;
+    if (offset >= total) {
+        return 0;
+    }
+
+    size_t written = 0;
+    if (offset < sizeof(captureMagic)) {
+        written = min(maxLen, sizeof(captureMagic) - offset);
+        memcpy(out, captureMagic + offset, written);
+        offset += written;
+    }
+
+    size_t dataOffset = offset - sizeof(captureMagic);
+    size_t count = min(maxLen - written, used - dataOffset);
+    readBytes((tail + dataOffset) % capacity, out + written, count);
+    return written + count;
+}
+
+void FrameCapture::endRead() {
+    reading = false;
+}
+
+size_t FrameCapture::getUsed() const {
+    return used;
+}
+
+uint32_t FrameCapture::getDroppedRecords() const {
+    return droppedRecords;
+}
+
+void FrameCapture::writeBytes(const uint8_t* data, size_t len) {
+    size_t first = min(len, capacity - head);
+    memcpy(buffer + head, data, first);
+    memcpy(buffer, data + first, len - first);
+    head = (head + len) % capacity;
+    used += len;
+}
+
+void FrameCapture::readBytes(size_t position, uint8_t* out, size_t len) const {
+    size_t first = min(len, capacity - position);
+    memcpy(out, buffer + position, first);
+    memcpy(out + first, buffer, len - first);
+}
+
+void FrameCapture::dropOldest() {
+    uint8_t header[RECORD_HEADER_SIZE];
+    readBytes(tail, header, RECORD_HEADER_SIZE);
+    uint32_t length;
+    memcpy(&length, header + 8, 4);
+
+    size_t recordSize = RECORD_HEADER_SIZE + length;
+    tail = (tail + recordSize) % capacity;
+    used -= recordSize;
+    droppedRecords++;
+}
@@ -0,0 +1,47 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <Arduino.h>
+
+#define FRAME_CAPTURE_FLAG_REQUEST_START 0x0001 // First chunk of a new HTTP request
+#define FRAME_CAPTURE_MAX_SIZE (2 * 1024 * 1024) // PSRAM is shared with the draw buffers and the JSON pool
+
+// Ring buffer of raw inbound chunks with arrival timestamps, kept in PSRAM. When full, the
+// oldest records are dropped. Downloaded as:
+//   "JRCAP1\0\0" then records of { uint32 timestampMs, uint16 flags, uint16 reserved,
+//   uint32 length, length bytes }, all little-endian.
+// Recording and reading both happen on the async TCP task, so no locking is needed.
+class FrameCapture {
+public:
+    FrameCapture();
+    bool begin(size_t capacity); // Allocates the buffer and starts recording, fails during a download
+    void stop();
+    void clear();
+    bool isRecording() const;
+    bool isReading() const;
+    void record(const uint8_t* data, size_t len, uint16_t flags);
+
+    // Download support: freeze the buffer, then read the serialized form in pieces
+    size_t beginRead(); // Returns the total download size
+    size_t read(uint8_t* out, size_t maxLen, size_t offset);
+    void endRead();
+
+    size_t getUsed() const;
+    uint32_t getDroppedRecords() const; // Evicted, oversized or arrived while a download was running
+
+private:
+    uint8_t* buffer;
+    size_t capacity;
+    size_t head; // Next write position
+    size_t tail; // Oldest record
+    size_t used;
+    bool recording;
+    bool reading;
+    uint32_t droppedRecords;
+
+    void writeBytes(const uint8_t* data, size_t len);
+    void readBytes(size_t position, uint8_t* out, size_t len) const;
+    void dropOldest();
+};
+
+#endif // FRAME_CAPTURE_H
@@ -5,6 +5,7 @@
 #include <LovyanGFX.hpp>
 #include <lgfx/v1/platforms/esp32s3/Panel_RGB.hpp>
 #include <lgfx/v1/platforms/esp32s3/Bus_RGB.hpp>
+#include "DisplayProfile.h"
 
 class LGFX : public lgfx::LGFX_Device {
 public:
@@ -16,10 +17,10 @@ public:
     // Panel configuration
     {
       auto cfg = _panel_instance.config();
-      cfg.memory_width  = 800;
-      cfg.memory_height = 480;
-      cfg.panel_width   = 800;
-      cfg.panel_height  = 480;
+      cfg.memory_width  = ActiveDisplayProfile::width;
+      cfg.memory_height = ActiveDisplayProfile::height;
+      cfg.panel_width   = ActiveDisplayProfile::width;
+      cfg.panel_height  = ActiveDisplayProfile::height;
       cfg.offset_x      = 0;
       cfg.offset_y      = 0;
       _panel_instance.config(cfg);
@@ -56,15 +57,15 @@ public:
       cfg.pin_vsync   = GPIO_NUM_40;
       cfg.pin_hsync   = GPIO_NUM_39;
       cfg.pin_pclk    = GPIO_NUM_0;
-      cfg.freq_write  = 14000000;
+      cfg.freq_write  = ActiveDisplayProfile::timing::pclkHz;
       cfg.hsync_polarity    = 0;
-      cfg.hsync_front_porch = 40;
-      cfg.hsync_pulse_width = 48;
-      cfg.hsync_back_porch  = 40;
+      cfg.hsync_front_porch = ActiveDisplayProfile::timing::hsyncFrontPorch;
+      cfg.hsync_pulse_width = ActiveDisplayProfile::timing::hsyncPulseWidth;
+      cfg.hsync_back_porch  = ActiveDisplayProfile::timing::hsyncBackPorch;
       cfg.vsync_polarity    = 0;
-      cfg.vsync_front_porch = 1;
-      cfg.vsync_pulse_width = 31;
-      cfg.vsync_back_porch  = 13;
+      cfg.vsync_front_porch = ActiveDisplayProfile::timing::vsyncFrontPorch;
+      cfg.vsync_pulse_width = ActiveDisplayProfile::timing::vsyncPulseWidth;
+      cfg.vsync_back_porch  = ActiveDisplayProfile::timing::vsyncBackPorch;
       cfg.pclk_active_neg   = 1;
       cfg.de_idle_high      = 0;
       cfg.pclk_idle_high    = 0;
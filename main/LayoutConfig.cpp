@@ -0,0 +1,206 @@
+#include "LayoutConfig.h"
+#include "DisplayProfile.h"
+
+#define DEFAULT_LABEL_FONT_SIZE 18
+#define DEFAULT_VALUE_FONT_SIZE 18
+#define DEFAULT_CELL_PADDING 0
+#define DEFAULT_CHART_HISTORY_POINTS 30
+#define DEFAULT_GRID_PAGE_INTERVAL_MS 5000
+#define DEFAULT_TEXT_COLOR 0xFFFFFF
+#define DEFAULT_TWEEN_FPS 30
+#define MIN_FONT_SIZE 12
+#define MAX_FONT_SIZE 30
+#define MAX_CELL_PADDING 32
+#define MAX_CHART_HISTORY_POINTS 240
+#define MAX_TWEEN_FPS 60
+
+namespace {
+
+int clampInt(int value, int low, int high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+// Only even sizes between 12 and 30 are compiled in
+int clampFontSize(int size) {
+    return clampInt(size, MIN_FONT_SIZE, MAX_FONT_SIZE) & ~1;
+}
+
+// Lets serializeJson feed bytes straight into FNV-1a without building a string
+struct HashWriter {
+    uint32_t value;
+
+    size_t write(uint8_t c) {
+        value ^= c;
+        value *= 16777619u;
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            write(buffer[i]);
+        }
+        return length;
+    }
+};
+
+uint32_t mix(uint32_t hash, int32_t value) {
+    // FNV-1a over the four bytes of value
+    for (int i = 0; i < 4; ++i) {
+        hash ^= (uint8_t)(value >> (i * 8));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+}
+
+LayoutConfig::LayoutConfig()
+    : layout(LAYOUT_NONE),
+      debugLevel(-1),
+      cpuGridLabelFontSize(DEFAULT_LABEL_FONT_SIZE),
+      cpuGridValueFontSize(DEFAULT_VALUE_FONT_SIZE),
+      otherGridLabelFontSize(DEFAULT_LABEL_FONT_SIZE),
+      otherGridValueFontSize(DEFAULT_VALUE_FONT_SIZE),
+      cpuGridCellPadding(DEFAULT_CELL_PADDING),
+      otherGridCellPadding(DEFAULT_CELL_PADDING),
+      cpuGridRows(3),
+      cpuGridCols(4),
+      otherGridRows(3),
+      otherGridCols(3),
+      cpuChartHistory(false),
+      cpuChartHistoryPoints(DEFAULT_CHART_HISTORY_POINTS),
+      gridPageInterval(DEFAULT_GRID_PAGE_INTERVAL_MS),
+      otherGridPage(-1),
+      tweenFps(DEFAULT_TWEEN_FPS),
+      textColor(DEFAULT_TEXT_COLOR),
+      alertRulesHash(0),
+      hasVersion(false),
+      version(0) {}
+
+bool LayoutConfig::parse(JsonObjectConst metadata) {
+    JsonVariantConst versionValue = metadata["ConfigVersion"];
+    if (!versionValue.isNull()) {
+        uint32_t sentVersion = versionValue.as<uint32_t>();
+        if (hasVersion && sentVersion == version) {
+            return false; // Sender says nothing changed
+        }
+        hasVersion = true;
+        version = sentVersion;
+    } else {
+        hasVersion = false;
+    }
+
+    // Layout and TextColor fall back to their defaults when absent, other fields keep their value
+    layout = LAYOUT_NONE;
+    textColor = DEFAULT_TEXT_COLOR;
+    alertRulesHash = 0;
+    debugLevel = -1;
+
+    for (JsonPairConst kv : metadata) {
+        const char* key = kv.key().c_str();
+        JsonVariantConst value = kv.value();
+
+        if (strcmp(key, "Layout") == 0) {
+            layout = parseLayout(value.as<const char*>());
+        } else if (strcmp(key, "DebugLevel") == 0) {
+            debugLevel = clampInt(value.as<int>(), 0, 4);
+        } else if (strcmp(key, "CPUGridLabelFontSize") == 0) {
+            cpuGridLabelFontSize = clampFontSize(value.as<int>());
+        } else if (strcmp(key, "CPUGridValueFontSize") == 0) {
+            cpuGridValueFontSize = clampFontSize(value.as<int>());
+        } else if (strcmp(key, "OtherGridLabelFontSize") == 0) {
+            otherGridLabelFontSize = clampFontSize(value.as<int>());
+        } else if (strcmp(key, "OtherGridValueFontSize") == 0) {
+            otherGridValueFontSize = clampFontSize(value.as<int>());
+        } else if (strcmp(key, "CPUGridCellPadding") == 0) {
+            cpuGridCellPadding = clampInt(value.as<int>(), 0, MAX_CELL_PADDING);
+        } else if (strcmp(key, "OtherGridCellPadding") == 0) {
+            otherGridCellPadding = clampInt(value.as<int>(), 0, MAX_CELL_PADDING);
+        } else if (strcmp(key, "CPUGridRows") == 0) {
+            cpuGridRows = max(value.as<int>(), 1); // Avoid division by zero
+        } else if (strcmp(key, "CPUGridCols") == 0) {
+            cpuGridCols = max(value.as<int>(), 1);
+        } else if (strcmp(key, "OtherGridRows") == 0) {
+            otherGridRows = max(value.as<int>(), 1);
+        } else if (strcmp(key, "OtherGridCols") == 0) {
+            otherGridCols = max(value.as<int>(), 1);
+        } else if (strcmp(key, "CPUChartMode") == 0) {
+            const char* mode = value.as<const char*>();
+            cpuChartHistory = mode != nullptr && strcmp(mode, "History") == 0;
+        } else if (strcmp(key, "CPUChartHistoryPoints") == 0) {
+            cpuChartHistoryPoints = clampInt(value.as<int>(), 2, MAX_CHART_HISTORY_POINTS);
+        } else if (strcmp(key, "GridPageInterval") == 0) {
+            gridPageInterval = max(value.as<int>(), 0); // 0 disables rotation
+        } else if (strcmp(key, "OtherGridPage") == 0) {
+            otherGridPage = value.as<int>();
+        } else if (strcmp(key, "TweenFps") == 0) {
+            tweenFps = clampInt(value.as<int>(), 0, MAX_TWEEN_FPS);
+        } else if (strcmp(key, "TextColor") == 0) {
+            textColor = parseColor(value.as<const char*>());
+        } else if (strcmp(key, "AlertRules") == 0) {
+            HashWriter writer = {2166136261u};
+            serializeJson(value, writer);
+            alertRulesHash = writer.value;
+        }
+    }
+
+    // Grid sizes are limited by the area the layout gives each grid, not by the whole screen
+    bool dashboard = layout == LAYOUT_CPU_DASH || layout == LAYOUT_CPU_DIALS;
+    cpuGridRows = min(cpuGridRows, (int)ActiveDisplayProfile::maxCpuGridRows);
+    cpuGridCols = min(cpuGridCols, (int)ActiveDisplayProfile::maxCpuGridCols);
+    otherGridRows = min(otherGridRows, (int)(dashboard ? ActiveDisplayProfile::maxDashGridRows : ActiveDisplayProfile::maxDataGridRows));
+    otherGridCols = min(otherGridCols, (int)(dashboard ? ActiveDisplayProfile::maxDashGridCols : ActiveDisplayProfile::maxDataGridCols));
+    return true;
+}
+
+uint32_t LayoutConfig::structureHash() const {
+    uint32_t hash = 2166136261u;
+    hash = mix(hash, layout);
+    hash = mix(hash, cpuGridCellPadding);
+    hash = mix(hash, otherGridCellPadding);
+    hash = mix(hash, cpuGridRows);
+    hash = mix(hash, cpuGridCols);
+    hash = mix(hash, otherGridRows);
+    hash = mix(hash, otherGridCols);
+    hash = mix(hash, cpuChartHistory);
+    hash = mix(hash, cpuChartHistoryPoints);
+    hash = mix(hash, gridPageInterval);
+    hash = mix(hash, otherGridPage);
+    return hash;
+}
+
+uint32_t LayoutConfig::styleHash() const {
+    uint32_t hash = 2166136261u;
+    hash = mix(hash, cpuGridLabelFontSize);
+    hash = mix(hash, cpuGridValueFontSize);
+    hash = mix(hash, otherGridLabelFontSize);
+    hash = mix(hash, otherGridValueFontSize);
+    hash = mix(hash, textColor);
+    return hash;
+}
+
+LayoutType LayoutConfig::parseLayout(const char* name) {
+    if (name == nullptr) {
+        return LAYOUT_NONE;
+    }
+    if (strcmp(name, "DataGrid") == 0) {
+        return LAYOUT_DATA_GRID;
+    }
+    if (strcmp(name, "CPUDash") == 0) {
+        return LAYOUT_CPU_DASH;
+    }
+    if (strcmp(name, "CPUDials") == 0) {
+        return LAYOUT_CPU_DIALS;
+    }
+    return LAYOUT_NONE;
+}
+
+uint32_t LayoutConfig::parseColor(const char* text) {
+    if (text == nullptr) {
+        return DEFAULT_TEXT_COLOR;
+    }
+    if (text[0] == '#') {
+        text++; // Remove the '#' character if present
+    }
+    return (uint32_t)strtoul(text, NULL, 16);
+}
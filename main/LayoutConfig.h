@@ -0,0 +1,49 @@
+#ifndef LAYOUT_CONFIG_H
+#define LAYOUT_CONFIG_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+enum LayoutType {
+    LAYOUT_NONE = 0,
+    LAYOUT_DATA_GRID,
+    LAYOUT_CPU_DASH,
+    LAYOUT_CPU_DIALS
+};
+
+// Typed view of CustomMetadata. Filled in one pass, validated and clamped in one place, and
+// split into two hashes: fields that require the screen to be rebuilt and fields that only
+// restyle existing widgets.
+struct LayoutConfig {
+    LayoutType layout;
+    int debugLevel; // -1 when not sent
+    int cpuGridLabelFontSize;
+    int cpuGridValueFontSize;
+    int otherGridLabelFontSize;
+    int otherGridValueFontSize;
+    int cpuGridCellPadding;
+    int otherGridCellPadding;
+    int cpuGridRows;
+    int cpuGridCols;
+    int otherGridRows;
+    int otherGridCols;
+    bool cpuChartHistory;
+    int cpuChartHistoryPoints;
+    int gridPageInterval;
+    int otherGridPage;
+    int tweenFps; // Arc and bar easing rate, 0 jumps straight to new values
+    uint32_t textColor; // 0xRRGGBB
+    uint32_t alertRulesHash; // Hash of the AlertRules array, 0 when absent
+    bool hasVersion;
+    uint32_t version; // Optional ConfigVersion sent by the host
+
+    LayoutConfig();
+    bool parse(JsonObjectConst metadata); // Returns false when ConfigVersion matches and parsing was skipped
+    uint32_t structureHash() const;
+    uint32_t styleHash() const;
+
+    static LayoutType parseLayout(const char* name);
+    static uint32_t parseColor(const char* text);
+};
+
+#endif // LAYOUT_CONFIG_H
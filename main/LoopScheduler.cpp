@@ -0,0 +1,186 @@
+#include "LoopScheduler.h"
+
+#define MAX_WAIT_MS 500 // Upper bound so a missed notification can never stall the loop
+#define UTILIZATION_REPORT_INTERVAL_US 10000000UL
+#define SOURCE_RATE_WINDOW_MS 10000
+#define SOURCE_STALE_MS 60000
+
+LoopScheduler::LoopScheduler()
+    : loopTask(nullptr), frameMutex(nullptr), sourceCount(0), nextSource(0), pendingCount(0), framesRejected(0),
+      lastFrameMs(0), busyStartUs(0), busyUs(0), windowStartUs(0) {}
+
+void LoopScheduler::init() {
+    loopTask = xTaskGetCurrentTaskHandle();
+    frameMutex = xSemaphoreCreateMutex();
+    if (frameMutex == nullptr) {
+        Serial.println("Error: Failed to create frame mutex");
+    }
+    lastFrameMs = millis();
+    busyStartUs = micros();
+    windowStartUs = busyStartUs;
+}
+
+void LoopScheduler::postFrame(const String& source, const String& json) {
+    if (frameMutex == nullptr) {
+        return;
+    }
+
+    xSemaphoreTake(frameMutex, portMAX_DELAY);
+    uint32_t now = millis();
+    SourceSlot* slot = findOrAddSource(source);
+    if (slot == nullptr) {
+        framesRejected++;
+        xSemaphoreGive(frameMutex);
+        return;
+    }
+
+    // Only the newest frame of a source matters, an unprocessed older one is replaced
+    if (slot->framePending) {
+        slot->framesCoalesced++;
+    } else {
+        slot->framePending = true;
+        pendingCount++;
+    }
+    slot->pendingFrame = json;
+    slot->framesPosted++;
+    slot->lastSeenMs = now;
+
+    slot->rateWindowFrames++;
+    uint32_t windowMs = now - slot->rateWindowStartMs;
+    if (windowMs >= SOURCE_RATE_WINDOW_MS) {
+        slot->framesPerSecond = 1000.0f * slot->rateWindowFrames / windowMs;
+        slot->rateWindowFrames = 0;
+        slot->rateWindowStartMs = now;
+    }
+    xSemaphoreGive(frameMutex);
+
+    lastFrameMs = now;
+    notify();
+}
+
+bool LoopScheduler::takeFrame(String& source, String& json) {
+    if (frameMutex == nullptr || pendingCount == 0) {
+        return false;
+    }
+
+    xSemaphoreTake(frameMutex, portMAX_DELAY);
+    bool taken = false;
+    for (size_t i = 0; i < sourceCount && !taken; ++i) {
+        SourceSlot& slot = sources[(nextSource + i) % sourceCount];
+        if (!slot.framePending) {
+            continue;
+        }
+        source = slot.id;
+        json = std::move(slot.pendingFrame);
+        slot.pendingFrame = "";
+        slot.framePending = false;
+        pendingCount--;
+        nextSource = (nextSource + i + 1) % sourceCount; // Start after this source next time
+        taken = true;
+    }
+    xSemaphoreGive(frameMutex);
+    return taken;
+}
+
+LoopScheduler::SourceSlot* LoopScheduler::findOrAddSource(const String& source) {
+    for (size_t i = 0; i < sourceCount; ++i) {
+        if (sources[i].id == source) {
+            return &sources[i];
+        }
+    }
+
+    // A full table reuses the slot of a source that went quiet
+    SourceSlot* slot = nullptr;
+    if (sourceCount < MAX_FRAME_SOURCES) {
+        slot = &sources[sourceCount++];
+    } else {
+        uint32_t now = millis();
+        for (size_t i = 0; i < sourceCount; ++i) {
+            if (!sources[i].framePending && now - sources[i].lastSeenMs > SOURCE_STALE_MS) {
+                slot = &sources[i];
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            return nullptr;
+        }
+    }
+
+    slot->id = source;
+    slot->pendingFrame = "";
+    slot->framePending = false;
+    slot->framesPosted = 0;
+    slot->framesCoalesced = 0;
+    slot->lastSeenMs = millis();
+    slot->rateWindowStartMs = slot->lastSeenMs;
+    slot->rateWindowFrames = 0;
+    slot->framesPerSecond = 0;
+    return slot;
+}
+
+String LoopScheduler::sourceStatsJson() {
+    if (frameMutex == nullptr) {
+        return "{}";
+    }
+
+    xSemaphoreTake(frameMutex, portMAX_DELAY);
+    uint32_t now = millis();
+    String json = "{\"framesRejected\":" + String(framesRejected) + ",\"sources\":[";
+    for (size_t i = 0; i < sourceCount; ++i) {
+        const SourceSlot& slot = sources[i];
+        uint32_t ageMs = now - slot.lastSeenMs;
+        if (i > 0) {
+            json += ",";
+        }
+        json += "{\"id\":\"" + slot.id + "\"" +
+                ",\"frames\":" + String(slot.framesPosted) +
+                ",\"coalesced\":" + String(slot.framesCoalesced) +
+                ",\"framesPerSecond\":" + String(slot.framesPerSecond, 2) +
+                ",\"msSinceLastFrame\":" + String(ageMs) +
+                ",\"stale\":" + (ageMs > SOURCE_STALE_MS ? "true" : "false") + "}";
+    }
+    json += "]}";
+    xSemaphoreGive(frameMutex);
+    return json;
+}
+
+void LoopScheduler::notify() {
+    if (loopTask == nullptr) {
+        return;
+    }
+    if (xTaskGetCurrentTaskHandle() == loopTask) {
+        return; // The loop is awake already and checks for work before sleeping
+    }
+    xTaskNotifyGive(loopTask);
+}
+
+void LoopScheduler::waitForWork(uint32_t timeoutMs) {
+    if (pendingCount > 0) {
+        return;
+    }
+
+    // Everything between two waits counts as busy time
+    uint32_t now = micros();
+    busyUs += now - busyStartUs;
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(min(timeoutMs, (uint32_t)MAX_WAIT_MS)));
+
+    busyStartUs = micros();
+}
+
+uint32_t LoopScheduler::msSinceLastFrame() const {
+    return millis() - lastFrameMs;
+}
+
+bool LoopScheduler::pollUtilization(float& busyPercent) {
+    uint32_t now = micros();
+    uint32_t elapsed = now - windowStartUs;
+    if (elapsed < UTILIZATION_REPORT_INTERVAL_US) {
+        return false;
+    }
+
+    busyPercent = 100.0f * (float)busyUs / (float)elapsed;
+    busyUs = 0;
+    windowStartUs = now;
+    return true;
+}
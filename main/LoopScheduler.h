@@ -0,0 +1,55 @@
+#ifndef LOOP_SCHEDULER_H
+#define LOOP_SCHEDULER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#define MAX_FRAME_SOURCES 8
+
+// Lets loop() sleep until LVGL's next timer is due or until work arrives from another task.
+// Frames posted from the web server task are handed over here so all LVGL calls stay on
+// the loop task. Each source has one latest-wins slot and slots are served round robin, so a
+// chatty sender only overwrites its own backlog and never delays the others.
+class LoopScheduler {
+public:
+    LoopScheduler();
+    void init();                                  // Call from setup(), binds to the loop task
+    void postFrame(const String& source, const String& json); // Safe from any task, wakes the loop
+    bool takeFrame(String& source, String& json);
+    void notify();                                // Wake the loop without a frame (serial, touch)
+    void waitForWork(uint32_t timeoutMs);
+    uint32_t msSinceLastFrame() const;
+    bool pollUtilization(float& busyPercent);     // True once per report interval
+    String sourceStatsJson();                     // Per-source counters as a JSON object, safe from any task
+
+private:
+    struct SourceSlot {
+        String id;
+        String pendingFrame;
+        bool framePending;
+        uint32_t framesPosted;
+        uint32_t framesCoalesced; // Replaced by a newer frame before the loop took them
+        uint32_t lastSeenMs;
+        uint32_t rateWindowStartMs;
+        uint32_t rateWindowFrames;
+        float framesPerSecond;
+    };
+
+    TaskHandle_t loopTask;
+    SemaphoreHandle_t frameMutex;
+    SourceSlot sources[MAX_FRAME_SOURCES];
+    size_t sourceCount;
+    size_t nextSource; // Round-robin cursor
+    volatile size_t pendingCount;
+    uint32_t framesRejected; // From sources beyond MAX_FRAME_SOURCES
+    volatile uint32_t lastFrameMs;
+    uint32_t busyStartUs;
+    uint64_t busyUs;
+    uint32_t windowStartUs;
+
+    SourceSlot* findOrAddSource(const String& source);
+};
+
+#endif // LOOP_SCHEDULER_H
@@ -0,0 +1,275 @@
+#include "MemoryPool.h"
+#include <esp_heap_caps.h>
+#include <algorithm>
+
+#define SLAB_SIZE 4096
+#define BULK_CLASS 0xFFFF
+#define BLOCK_MAGIC 0xB10C
+
+MemoryPool lvglPool;
+
+namespace {
+
+// Placed in front of every block so free/realloc know where it came from
+struct BlockHeader {
+    uint32_t size;
+    uint16_t sizeClass;
+    uint16_t magic;
+};
+
+const size_t classSizes[MEMORY_POOL_CLASS_COUNT] = {16, 32, 64, 128, 256};
+
+void* allocateBulk(size_t size) {
+    void* ptr = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (ptr == nullptr) {
+        ptr = heap_caps_malloc(size, MALLOC_CAP_8BIT); // No PSRAM or PSRAM exhausted
+    }
+    return ptr;
+}
+
+void* reallocateBulk(void* ptr, size_t size) {
+    void* newPtr = heap_caps_realloc(ptr, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (newPtr == nullptr) {
+        newPtr = heap_caps_realloc(ptr, size, MALLOC_CAP_8BIT);
+    }
+    return newPtr;
+}
+
+}
+
+MemoryPool::MemoryPool() : stats() {
+    portMUX_INITIALIZE(&lock);
+    for (int i = 0; i < MEMORY_POOL_CLASS_COUNT; ++i) {
+        freeLists[i] = nullptr;
+    }
+}
+
+int MemoryPool::sizeClassFor(size_t size) {
+    for (int i = 0; i < MEMORY_POOL_CLASS_COUNT; ++i) {
+        if (size <= classSizes[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+size_t MemoryPool::classSize(int sizeClass) {
+    return classSizes[sizeClass];
+}
+
+bool MemoryPool::addSlab(int sizeClass) {
+    // Slabs are never returned, blocks only move between the free list and their users
+    uint8_t* slab = (uint8_t*)heap_caps_malloc(SLAB_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (slab == nullptr) {
+        return false;
+    }
+
+    // Chain the slab's blocks privately, then splice the chain in under the lock
+    size_t blockSize = sizeof(BlockHeader) + classSize(sizeClass);
+    FreeBlock* first = nullptr;
+    FreeBlock* last = nullptr;
+    for (size_t offset = 0; offset + blockSize <= SLAB_SIZE; offset += blockSize) {
+        FreeBlock* block = (FreeBlock*)(slab + offset);
+        block->next = first;
+        first = block;
+        if (last == nullptr) {
+            last = block;
+        }
+    }
+
+    portENTER_CRITICAL(&lock);
+    last->next = freeLists[sizeClass];
+    freeLists[sizeClass] = first;
+    stats.slabBytes += SLAB_SIZE;
+    portEXIT_CRITICAL(&lock);
+    return true;
+}
+
+void* MemoryPool::allocate(size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+    int sizeClass = sizeClassFor(size);
+    BlockHeader* header = nullptr;
+
+    if (sizeClass < 0) {
+        header = (BlockHeader*)allocateBulk(sizeof(BlockHeader) + size);
+        portENTER_CRITICAL(&lock);
+        if (header == nullptr) {
+            stats.allocFailures++;
+        } else {
+            stats.psramInUse += size;
+            stats.psramHighWater = std::max(stats.psramHighWater, stats.psramInUse);
+        }
+        portEXIT_CRITICAL(&lock);
+        if (header == nullptr) {
+            return nullptr;
+        }
+        header->sizeClass = BULK_CLASS;
+    } else {
+        // Slabs are allocated outside the critical section, the heap takes its own lock
+        portENTER_CRITICAL(&lock);
+        bool empty = freeLists[sizeClass] == nullptr;
+        portEXIT_CRITICAL(&lock);
+        if (empty && !addSlab(sizeClass)) {
+            // Internal SRAM exhausted, fall back to a bulk allocation
+            header = (BlockHeader*)allocateBulk(sizeof(BlockHeader) + size);
+            if (header == nullptr) {
+                portENTER_CRITICAL(&lock);
+                stats.allocFailures++;
+                portEXIT_CRITICAL(&lock);
+                return nullptr;
+            }
+            header->sizeClass = BULK_CLASS;
+            portENTER_CRITICAL(&lock);
+            stats.psramInUse += size;
+            stats.psramHighWater = std::max(stats.psramHighWater, stats.psramInUse);
+            portEXIT_CRITICAL(&lock);
+        } else {
+            portENTER_CRITICAL(&lock);
+            FreeBlock* block = freeLists[sizeClass];
+            if (block != nullptr) {
+                freeLists[sizeClass] = block->next;
+                stats.sramInUse += classSize(sizeClass);
+                stats.sramHighWater = std::max(stats.sramHighWater, stats.sramInUse);
+            }
+            portEXIT_CRITICAL(&lock);
+            if (block == nullptr) {
+                return allocate(size); // Another task took the new slab's blocks, retry
+            }
+            header = (BlockHeader*)block;
+            header->sizeClass = sizeClass;
+        }
+    }
+
+    header->size = size;
+    header->magic = BLOCK_MAGIC;
+    return header + 1;
+}
+
+void MemoryPool::deallocate(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    BlockHeader* header = (BlockHeader*)ptr - 1;
+    if (header->magic != BLOCK_MAGIC) {
+        Serial.println("MemoryPool: free of a block that was not allocated by the pool");
+        return;
+    }
+    header->magic = 0;
+
+    if (header->sizeClass == BULK_CLASS) {
+        portENTER_CRITICAL(&lock);
+        stats.psramInUse -= header->size;
+        portEXIT_CRITICAL(&lock);
+        heap_caps_free(header);
+        return;
+    }
+
+    int sizeClass = header->sizeClass;
+    FreeBlock* block = (FreeBlock*)header;
+    portENTER_CRITICAL(&lock);
+    block->next = freeLists[sizeClass];
+    freeLists[sizeClass] = block;
+    stats.sramInUse -= classSize(sizeClass);
+    portEXIT_CRITICAL(&lock);
+}
+
+void* MemoryPool::reallocate(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return allocate(size);
+    }
+    if (size == 0) {
+        deallocate(ptr);
+        return nullptr;
+    }
+
+    BlockHeader* header = (BlockHeader*)ptr - 1;
+    if (header->magic != BLOCK_MAGIC) {
+        Serial.println("MemoryPool: realloc of a block that was not allocated by the pool");
+        return nullptr;
+    }
+    if (header->sizeClass != BULK_CLASS) {
+        // Grow or shrink in place while the request still fits the block's class
+        if (size <= classSize(header->sizeClass) && sizeClassFor(size) == header->sizeClass) {
+            header->size = size;
+            return ptr;
+        }
+    } else if (sizeClassFor(size) < 0) {
+        size_t oldSize = header->size;
+        BlockHeader* newHeader = (BlockHeader*)reallocateBulk(header, sizeof(BlockHeader) + size);
+        if (newHeader == nullptr) {
+            portENTER_CRITICAL(&lock);
+            stats.allocFailures++;
+            portEXIT_CRITICAL(&lock);
+            return nullptr;
+        }
+        newHeader->size = size;
+        portENTER_CRITICAL(&lock);
+        stats.psramInUse = stats.psramInUse - oldSize + size;
+        stats.psramHighWater = std::max(stats.psramHighWater, stats.psramInUse);
+        portEXIT_CRITICAL(&lock);
+        return newHeader + 1;
+    }
+
+    // Moving between a size class and bulk storage
+    void* newPtr = allocate(size);
+    if (newPtr == nullptr) {
+        return nullptr;
+    }
+    memcpy(newPtr, ptr, std::min((size_t)header->size, size));
+    deallocate(ptr);
+    return newPtr;
+}
+
+MemoryPoolStats MemoryPool::getStats() const {
+    portENTER_CRITICAL(&lock);
+    MemoryPoolStats snapshot = stats;
+    portEXIT_CRITICAL(&lock);
+
+    snapshot.internalFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    snapshot.internalLargestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    snapshot.fragmentationPercent = snapshot.internalFree == 0
+        ? 0
+        : 100 - (int)(snapshot.internalLargestBlock * 100 / snapshot.internalFree);
+    return snapshot;
+}
+
+void MemoryPool::logStats() const {
+    MemoryPoolStats s = getStats();
+    Serial.printf("MemoryPool: SRAM %u/%u B (peak %u), PSRAM %u B (peak %u), failures %u\n",
+                  (unsigned)s.sramInUse, (unsigned)s.slabBytes, (unsigned)s.sramHighWater,
+                  (unsigned)s.psramInUse, (unsigned)s.psramHighWater, (unsigned)s.allocFailures);
+    Serial.printf("MemoryPool: internal heap free %u B, largest block %u B, fragmentation %d%%\n",
+                  (unsigned)s.internalFree, (unsigned)s.internalLargestBlock, s.fragmentationPercent);
+}
+
+void* PsramJsonAllocator::allocate(size_t size) {
+    return allocateBulk(size);
+}
+
+void PsramJsonAllocator::deallocate(void* ptr) {
+    heap_caps_free(ptr);
+}
+
+void* PsramJsonAllocator::reallocate(void* ptr, size_t newSize) {
+    return reallocateBulk(ptr, newSize);
+}
+
+extern "C" {
+
+void* lv_pool_malloc(size_t size) {
+    return lvglPool.allocate(size);
+}
+
+void lv_pool_free(void* ptr) {
+    lvglPool.deallocate(ptr);
+}
+
+void* lv_pool_realloc(void* ptr, size_t size) {
+    return lvglPool.reallocate(ptr, size);
+}
+
+}
@@ -0,0 +1,75 @@
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Size-class pool for LVGL. Small, hot allocations come from fixed-size blocks carved out of
+// internal SRAM slabs, so freeing them never fragments the heap. Anything larger than the
+// biggest class is bulk data and goes to PSRAM (internal heap if no PSRAM is present).
+//
+// To route lv_mem through the pool, set the following in lv_conf.h:
+//   #define LV_MEM_CUSTOM 1
+//   #define LV_MEM_CUSTOM_INCLUDE <stddef.h>
+//   #define LV_MEM_CUSTOM_ALLOC   lv_pool_malloc
+//   #define LV_MEM_CUSTOM_FREE    lv_pool_free
+//   #define LV_MEM_CUSTOM_REALLOC lv_pool_realloc
+//   void* lv_pool_malloc(size_t size);
+//   void lv_pool_free(void* ptr);
+//   void* lv_pool_realloc(void* ptr, size_t size);
+
+#define MEMORY_POOL_CLASS_COUNT 5
+
+struct MemoryPoolStats {
+    size_t sramInUse;           // Bytes handed out from the size classes
+    size_t sramHighWater;
+    size_t psramInUse;          // Bytes handed out as bulk allocations
+    size_t psramHighWater;
+    size_t slabBytes;           // Internal SRAM reserved for the size classes
+    size_t allocFailures;
+    size_t internalFree;        // Whole internal heap, not only the pool
+    size_t internalLargestBlock;
+    int fragmentationPercent;   // 100 - largest free block / free bytes
+};
+
+class MemoryPool {
+public:
+    MemoryPool();
+    void* allocate(size_t size);
+    void deallocate(void* ptr);
+    void* reallocate(void* ptr, size_t size);
+    MemoryPoolStats getStats() const;
+    void logStats() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* freeLists[MEMORY_POOL_CLASS_COUNT];
+    MemoryPoolStats stats;
+    mutable portMUX_TYPE lock;
+
+    bool addSlab(int sizeClass);
+    static int sizeClassFor(size_t size);
+    static size_t classSize(int sizeClass);
+};
+
+// Allocator for ArduinoJson documents: the document pool is bulk data and lives in PSRAM
+struct PsramJsonAllocator {
+    void* allocate(size_t size);
+    void deallocate(void* ptr);
+    void* reallocate(void* ptr, size_t newSize);
+};
+
+typedef BasicJsonDocument<PsramJsonAllocator> PsramJsonDocument;
+
+extern MemoryPool lvglPool;
+
+extern "C" {
+void* lv_pool_malloc(size_t size);
+void lv_pool_free(void* ptr);
+void* lv_pool_realloc(void* ptr, size_t size);
+}
+
+#endif // MEMORY_POOL_H
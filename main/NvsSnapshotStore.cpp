@@ -0,0 +1,39 @@
+#include "NvsSnapshotStore.h"
+
+#define SNAPSHOT_KEY "snapshot"
+// The NVS partition is only ~20 KB and shared with the settings; one 4 KB page per blob
+// leaves room for the settings and for wear levelling to rotate pages
+#define NVS_SNAPSHOT_MAX_SIZE 4000
+
+NvsSnapshotStore::NvsSnapshotStore(const char* nameSpace)
+    : nameSpace(nameSpace), opened(false) {}
+
+bool NvsSnapshotStore::begin() {
+    opened = preferences.begin(nameSpace, false);
+    if (!opened) {
+        Serial.println("Error: Failed to open NVS namespace for snapshots");
+    }
+    return opened;
+}
+
+size_t NvsSnapshotStore::read(uint8_t* buffer, size_t maxLen) {
+    if (!opened) {
+        return 0;
+    }
+    size_t len = preferences.getBytesLength(SNAPSHOT_KEY);
+    if (len == 0 || len > maxLen) {
+        return 0;
+    }
+    return preferences.getBytes(SNAPSHOT_KEY, buffer, maxLen);
+}
+
+bool NvsSnapshotStore::write(const uint8_t* data, size_t len) {
+    if (!opened) {
+        return false;
+    }
+    return preferences.putBytes(SNAPSHOT_KEY, data, len) == len;
+}
+
+size_t NvsSnapshotStore::maxSize() const {
+    return NVS_SNAPSHOT_MAX_SIZE;
+}
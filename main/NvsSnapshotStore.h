@@ -0,0 +1,22 @@
+#ifndef NVS_SNAPSHOT_STORE_H
+#define NVS_SNAPSHOT_STORE_H
+
+#include <Preferences.h>
+#include "SnapshotStore.h"
+
+// Keeps the snapshot as one blob in an NVS namespace
+class NvsSnapshotStore : public SnapshotStore {
+public:
+    NvsSnapshotStore(const char* nameSpace);
+    bool begin() override;
+    size_t read(uint8_t* buffer, size_t maxLen) override;
+    bool write(const uint8_t* data, size_t len) override;
+    size_t maxSize() const override;
+
+private:
+    const char* nameSpace;
+    Preferences preferences;
+    bool opened;
+};
+
+#endif // NVS_SNAPSHOT_STORE_H
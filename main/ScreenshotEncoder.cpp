@@ -0,0 +1,110 @@
+#include "ScreenshotEncoder.h"
+#include <string.h>
+
+#define BMP_HEADER_SIZE 66 // File header, BITMAPINFOHEADER and three channel masks
+#define BMP_BITFIELDS 3
+
+ScreenshotEncoder::ScreenshotEncoder(int width, int height, Format format, RowReader reader)
+    : width(width), height(height), format(format), reader(reader), row(width), pendingPos(0), nextRow(0) {
+    encodeHeader();
+}
+
+size_t ScreenshotEncoder::totalSize() const {
+    if (format != FORMAT_BMP) {
+        return 0;
+    }
+    return BMP_HEADER_SIZE + rowStride() * height;
+}
+
+size_t ScreenshotEncoder::read(uint8_t* out, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (pendingPos == pending.size()) {
+            if (nextRow >= height) {
+                break;
+            }
+            pending.clear();
+            pendingPos = 0;
+            encodeRow(nextRow++);
+        }
+
+        size_t count = pending.size() - pendingPos;
+        if (count > maxLen - written) {
+            count = maxLen - written;
+        }
+        memcpy(out + written, pending.data() + pendingPos, count);
+        pendingPos += count;
+        written += count;
+    }
+    return written;
+}
+
+size_t ScreenshotEncoder::rowStride() const {
+    return (width * 2 + 3) & ~3; // BMP rows are padded to four bytes
+}
+
+void ScreenshotEncoder::encodeHeader() {
+    if (format == FORMAT_BMP) {
+        uint32_t imageSize = rowStride() * height;
+        pending.push_back('B');
+        pending.push_back('M');
+        put32(BMP_HEADER_SIZE + imageSize);
+        put32(0);
+        put32(BMP_HEADER_SIZE);
+
+        put32(40);
+        put32(width);
+        put32((uint32_t)-height); // Negative height: rows are stored top-down
+        put16(1);
+        put16(16);
+        put32(BMP_BITFIELDS);
+        put32(imageSize);
+        put32(2835); // 72 DPI
+        put32(2835);
+        put32(0);
+        put32(0);
+
+        put32(0xF800);
+        put32(0x07E0);
+        put32(0x001F);
+    } else {
+        const char magic[] = "JRRLE1";
+        pending.insert(pending.end(), magic, magic + 6);
+        put16(width);
+        put16(height);
+    }
+}
+
+void ScreenshotEncoder::encodeRow(int y) {
+    reader(y, row.data());
+
+    if (format == FORMAT_BMP) {
+        for (int x = 0; x < width; ++x) {
+            put16(row[x]);
+        }
+        pending.resize(rowStride(), 0);
+        return;
+    }
+
+    int x = 0;
+    while (x < width) {
+        uint16_t color = row[x];
+        int run = 1;
+        while (x + run < width && row[x + run] == color && run < 0xFFFF) {
+            run++;
+        }
+        put16(run);
+        put16(color);
+        x += run;
+    }
+}
+
+void ScreenshotEncoder::put16(uint16_t value) {
+    pending.push_back(value & 0xFF);
+    pending.push_back(value >> 8);
+}
+
+void ScreenshotEncoder::put32(uint32_t value) {
+    put16(value & 0xFFFF);
+    put16(value >> 16);
+}
@@ -0,0 +1,44 @@
+#ifndef SCREENSHOT_ENCODER_H
+#define SCREENSHOT_ENCODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <vector>
+
+// Streams an RGB565 image row by row as a BMP or a simple run-length format, so the whole
+// framebuffer is never copied. Pure C++ so the host build can write golden images with it.
+//
+// RLE layout: "JRRLE1", uint16 width, uint16 height, then per row runs of
+// { uint16 count, uint16 rgb565 } that never cross a row boundary, all little-endian.
+class ScreenshotEncoder {
+public:
+    enum Format {
+        FORMAT_BMP,
+        FORMAT_RLE
+    };
+
+    typedef std::function<void(int y, uint16_t* row)> RowReader;
+
+    ScreenshotEncoder(int width, int height, Format format, RowReader reader);
+    size_t totalSize() const; // 0 when the size is not known up front (RLE)
+    size_t read(uint8_t* out, size_t maxLen); // Returns 0 once the image is complete
+
+private:
+    int width;
+    int height;
+    Format format;
+    RowReader reader;
+    std::vector<uint16_t> row;
+    std::vector<uint8_t> pending; // Encoded bytes not yet handed out
+    size_t pendingPos;
+    int nextRow;
+
+    size_t rowStride() const;
+    void encodeHeader();
+    void encodeRow(int y);
+    void put16(uint16_t value);
+    void put32(uint32_t value);
+};
+
+#endif // SCREENSHOT_ENCODER_H
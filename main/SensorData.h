@@ -0,0 +1,27 @@
+#ifndef SENSOR_DATA_H
+#define SENSOR_DATA_H
+
+#include <Arduino.h>
+#include <vector>
+
+struct SensorData {
+    String tag;
+    String value;
+    int order;
+    String category;
+    String componentName;
+    uint16_t alertSlot; // AlertEngine slot, ALERT_NO_SLOT when unassigned
+
+    bool operator<(const SensorData& other) const {
+        return order < other.order;
+    }
+};
+
+// Latest frame of one sender, merged with the other senders' for display
+struct SourceSensors {
+    String source;
+    std::vector<SensorData> sensors; // Tags without the source prefix
+    uint32_t lastSeenMs;
+};
+
+#endif // SENSOR_DATA_H
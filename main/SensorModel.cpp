@@ -0,0 +1,154 @@
+#include "SensorModel.h"
+#include <algorithm>
+
+#define SOURCE_EXPIRY_MS 60000 // Sensors of a source that stopped sending are dropped after this
+
+SensorModel::SensorModel()
+    : config(),
+      structureHash(0),
+      styleHash(config.styleHash()),
+      alertRulesHash(0) {}
+
+FrameChanges SensorModel::apply(const String& source, JsonDocument& doc) {
+    // One pass over CustomMetadata, skipped entirely when the sender's ConfigVersion is unchanged.
+    // Frames without metadata only contribute sensors, so extra hosts need not repeat the layout.
+    FrameChanges changes = {false, false, false, false};
+    JsonObjectConst metadata = doc["metadata"]["CustomMetadata"];
+    if (!metadata.isNull() && config.parse(metadata)) {
+        changes.configParsed = true;
+
+        // Rebuild only for structural changes, fonts and TextColor are restyled in place
+        uint32_t nextStructureHash = config.structureHash();
+        uint32_t nextStyleHash = config.styleHash();
+        changes.structure = nextStructureHash != structureHash;
+        changes.style = nextStyleHash != styleHash;
+        structureHash = nextStructureHash;
+        styleHash = nextStyleHash;
+
+        // Rules are compiled into the engine's per-slot table only when they change
+        if (config.alertRulesHash != alertRulesHash) {
+            alertEngine.compile(metadata["AlertRules"]);
+            alertRulesHash = config.alertRulesHash;
+            changes.alertRules = true;
+        }
+    }
+
+    storeSourceSensors(source, doc);
+    mergeSourceSensors();
+    raiseAlerts();
+    return changes;
+}
+
+void SensorModel::setSourceDropHandler(SourceDropHandler handler) {
+    sourceDropHandler = handler;
+}
+
+const std::vector<SensorData>& SensorModel::cpuGridSensors() const {
+    return cpuGridCollection.empty() ? cpuCollection : cpuGridCollection;
+}
+
+void SensorModel::storeSourceSensors(const String& source, JsonDocument& doc) {
+    // Restored sensors give way to live data, sources that went quiet are dropped
+    uint32_t now = millis();
+    bool live = source != SNAPSHOT_SOURCE;
+    for (size_t i = sourceSensors.size(); i-- > 0;) {
+        const SourceSensors& candidate = sourceSensors[i];
+        if (candidate.source == source) {
+            continue;
+        }
+        if ((live && candidate.source == SNAPSHOT_SOURCE) || now - candidate.lastSeenMs > SOURCE_EXPIRY_MS) {
+            if (sourceDropHandler) {
+                sourceDropHandler(candidate.source);
+            }
+            alertEngine.releaseSource(candidate.source); // Source ids derived from addresses would otherwise use up the slots
+            sourceSensors.erase(sourceSensors.begin() + i);
+        }
+    }
+
+    SourceSensors* entry = nullptr;
+    for (SourceSensors& candidate : sourceSensors) {
+        if (candidate.source == source) {
+            entry = &candidate;
+            break;
+        }
+    }
+    if (entry == nullptr) {
+        sourceSensors.push_back(SourceSensors());
+        entry = &sourceSensors.back();
+        entry->source = source;
+    }
+    entry->lastSeenMs = now;
+
+    // Replace this source's sensors, the other sources keep their latest values
+    std::vector<SensorData>& sensors = entry->sensors;
+    sensors.clear();
+    for (JsonPair kv : doc["sensors"].as<JsonObject>()) {
+        String sensorTag = kv.key().c_str();
+        JsonArray sensorDataArray = kv.value().as<JsonArray>();
+        String unit = sensorDataArray[0]["Unit"] | ""; // Snapshots fold the unit into the value
+        String value = sensorDataArray[0]["Value"].as<String>();
+        int sensorOrder = sensorDataArray[0]["SensorOrder"].as<int>();
+        String category = sensorDataArray[0]["Category"].as<String>();
+        String componentName = sensorDataArray[0]["ComponentName"].as<String>();
+
+        // Only sensors whose value changed are checked against their rule
+        uint16_t alertSlot = alertEngine.slotFor(source, sensorTag, category, componentName);
+        alertEngine.update(alertSlot, value.toFloat());
+
+        SensorData sensorData = {sensorTag, unit.isEmpty() ? value : value + " " + unit, sensorOrder, category, componentName, alertSlot};
+        sensors.push_back(sensorData);
+    }
+
+    // The dashboards show each source's sensors in SensorOrder, the data grid keeps frame order
+    if (config.layout != LAYOUT_DATA_GRID) {
+        std::stable_sort(sensors.begin(), sensors.end());
+    }
+}
+
+void SensorModel::mergeSourceSensors() {
+    sensorCollection.clear();
+    cpuCollection.clear();
+    otherCollection.clear();
+
+    // Tags are prefixed with their source only once more than one source is shown
+    bool namespaced = sourceSensors.size() > 1;
+    for (const SourceSensors& entry : sourceSensors) {
+        for (const SensorData& sensor : entry.sensors) {
+            SensorData sensorData = sensor;
+            if (namespaced) {
+                sensorData.tag = entry.source + ":" + sensor.tag;
+            }
+
+            if (config.layout == LAYOUT_DATA_GRID) {
+                sensorCollection.push_back(sensorData);
+            } else if (config.layout == LAYOUT_CPU_DASH || config.layout == LAYOUT_CPU_DIALS) {
+                if (sensorData.category == "Load" && sensorData.componentName == "CPU") {
+                    cpuCollection.push_back(sensorData);
+                } else {
+                    otherCollection.push_back(sensorData);
+                }
+            }
+        }
+    }
+}
+
+void SensorModel::raiseAlerts() {
+    // Sensors alerting on a rule with Raise move to the front
+    cpuGridCollection.clear();
+    if (!alertEngine.hasRaiseRules()) {
+        return;
+    }
+    const AlertEngine& alerts = alertEngine;
+    auto raised = [&alerts](const SensorData& sensor) {
+        return alerts.isRaised(sensor.alertSlot);
+    };
+
+    if (config.layout == LAYOUT_DATA_GRID) {
+        std::stable_partition(sensorCollection.begin(), sensorCollection.end(), raised);
+    } else if (config.layout == LAYOUT_CPU_DASH || config.layout == LAYOUT_CPU_DIALS) {
+        // Raise only reorders grid placement, the chart keeps one bar or series per core in sensor order
+        cpuGridCollection = cpuCollection;
+        std::stable_partition(cpuGridCollection.begin(), cpuGridCollection.end(), raised);
+        std::stable_partition(otherCollection.begin(), otherCollection.end(), raised);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SENSOR_MODEL_H
+#define SENSOR_MODEL_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <functional>
+#include <vector>
+#include "AlertEngine.h"
+#include "LayoutConfig.h"
+#include "SensorData.h"
+
+#define SNAPSHOT_SOURCE "" // Sensors restored from flash, replaced by the first live frame
+
+// What a frame changed, so the display rebuilds or restyles only what it has to
+struct FrameChanges {
+    bool configParsed; // CustomMetadata was sent and its ConfigVersion changed
+    bool structure;    // config.structureHash() changed, the screen has to be rebuilt
+    bool style;        // config.styleHash() changed, the shared styles have to be updated
+    bool alertRules;   // The rules were recompiled and every slot was reset
+};
+
+// The part of frame handling that needs no widgets: CustomMetadata, per-source sensor storage
+// and expiry, alert evaluation and the collections the layouts bind to. DisplayManager drives
+// it for every frame; the host replay drives it directly.
+class SensorModel {
+public:
+    typedef std::function<void(const String& source)> SourceDropHandler;
+
+    SensorModel();
+    FrameChanges apply(const String& source, JsonDocument& doc);
+    void setSourceDropHandler(SourceDropHandler handler);
+    const std::vector<SensorData>& cpuGridSensors() const;
+
+    LayoutConfig config;
+    AlertEngine alertEngine;
+    std::vector<SourceSensors> sourceSensors;
+    std::vector<SensorData> sensorCollection;
+    std::vector<SensorData> cpuCollection;     // Sensor order, the chart's bars and series follow it
+    std::vector<SensorData> cpuGridCollection; // cpuCollection with raised sensors first, only filled with Raise rules
+    std::vector<SensorData> otherCollection;
+
+private:
+    uint32_t structureHash; // config.structureHash() last reported
+    uint32_t styleHash;     // config.styleHash() last reported
+    uint32_t alertRulesHash; // config.alertRulesHash the engine was compiled from
+    SourceDropHandler sourceDropHandler;
+
+    void storeSourceSensors(const String& source, JsonDocument& doc);
+    void mergeSourceSensors(); // Rebuilds the collections from every source's latest sensors
+    void raiseAlerts();
+};
+
+#endif // SENSOR_MODEL_H
@@ -0,0 +1,146 @@
+#include "SnapshotManager.h"
+
+#define SNAPSHOT_MAX_SIZE 8192
+#define SNAPSHOT_DOCUMENT_CAPACITY 8192
+#define SNAPSHOT_METADATA_CAPACITY 4096
+#define LAYOUT_WRITE_DELAY_MS 10000     // Layout changes are saved soon, but not on every edit
+#define VALUE_WRITE_INTERVAL_MS 600000  // Sensor values alone only refresh the snapshot every 10 minutes
+
+SnapshotManager::SnapshotManager(SnapshotStore& store)
+    : store(store), compactDoc(nullptr), metadataDoc(nullptr), buffer(nullptr), savedHash(0),
+      lastWriteMs(0), writeCount(0), layoutPending(false), written(false), skipped(false) {}
+
+bool SnapshotManager::begin() {
+    buffer = (uint8_t*)ps_malloc(SNAPSHOT_MAX_SIZE);
+    if (buffer == nullptr) {
+        buffer = (uint8_t*)malloc(SNAPSHOT_MAX_SIZE);
+    }
+    if (buffer == nullptr) {
+        Serial.println("Error: Failed to allocate snapshot buffer");
+        return false;
+    }
+    compactDoc = new PsramJsonDocument(SNAPSHOT_DOCUMENT_CAPACITY);
+    metadataDoc = new PsramJsonDocument(SNAPSHOT_METADATA_CAPACITY);
+    return store.begin();
+}
+
+void SnapshotManager::setMetadata(JsonObjectConst metadata) {
+    if (metadataDoc == nullptr) {
+        return;
+    }
+    metadataDoc->set(metadata);
+    if (metadataDoc->overflowed()) {
+        Serial.println("Error: CustomMetadata does not fit the snapshot, snapshots paused");
+        metadataDoc->clear();
+    }
+}
+
+void SnapshotManager::record(const std::vector<SourceSensors>& sources, bool layoutChanged) {
+    // Without a layout the snapshot would restore as a blank screen
+    if (buffer == nullptr || metadataDoc->isNull()) {
+        return;
+    }
+
+    // Decide before serializing, most frames are not due for a write
+    layoutPending = layoutPending || layoutChanged || !written;
+    uint32_t interval = layoutPending ? LAYOUT_WRITE_DELAY_MS : VALUE_WRITE_INTERVAL_MS;
+    if ((written || skipped) && millis() - lastWriteMs < interval) {
+        return;
+    }
+
+    size_t len = serializeCompact(sources);
+    lastWriteMs = millis();
+    skipped = len == 0;
+    if (len == 0) {
+        return;
+    }
+
+    uint32_t contentHash = hash(buffer, len);
+    if (written && contentHash == savedHash) {
+        layoutPending = false;
+        return; // Identical content, spare the flash
+    }
+
+    if (store.write(buffer, len)) {
+        savedHash = contentHash;
+        written = true;
+        layoutPending = false;
+        writeCount++;
+    } else {
+        Serial.println("Error: Failed to write snapshot");
+    }
+}
+
+bool SnapshotManager::load(JsonDocument& doc) {
+    if (buffer == nullptr) {
+        return false;
+    }
+
+    size_t len = store.read(buffer, SNAPSHOT_MAX_SIZE);
+    if (len == 0) {
+        return false;
+    }
+
+    DeserializationError error = deserializeMsgPack(doc, buffer, len);
+    if (error) {
+        Serial.print("Snapshot deserializeMsgPack() failed: ");
+        Serial.println(error.c_str());
+        return false;
+    }
+
+    // Sources that send no layout keep the restored one in later snapshots
+    metadataDoc->set(doc["metadata"]["CustomMetadata"]);
+    savedHash = hash(buffer, len);
+    written = true;
+    lastWriteMs = millis();
+    return true;
+}
+
+uint32_t SnapshotManager::getWriteCount() const {
+    return writeCount;
+}
+
+size_t SnapshotManager::serializeCompact(const std::vector<SourceSensors>& sources) {
+    compactDoc->clear();
+    JsonObject metadata = compactDoc->createNestedObject("metadata");
+    metadata["CustomMetadata"] = metadataDoc->as<JsonObjectConst>();
+
+    // Tags are namespaced as in SensorModel::mergeSourceSensors and SensorOrder is the merged
+    // position, so the restored single source shows the same sensors in the same order. Only the
+    // fields the layouts read are kept, the unit stays folded into the displayed value.
+    JsonObject sensors = compactDoc->createNestedObject("sensors");
+    bool namespaced = sources.size() > 1;
+    int order = 0;
+    for (const SourceSensors& entry : sources) {
+        for (const SensorData& sensor : entry.sensors) {
+            String tag = namespaced ? entry.source + ":" + sensor.tag : sensor.tag;
+            JsonObject saved = sensors.createNestedArray(tag).createNestedObject();
+            saved["Value"] = sensor.value;
+            saved["SensorOrder"] = order++;
+            saved["Category"] = sensor.category;
+            saved["ComponentName"] = sensor.componentName;
+        }
+    }
+
+    if (compactDoc->overflowed()) {
+        Serial.println("Error: Snapshot does not fit, skipping write");
+        return 0;
+    }
+    size_t len = measureMsgPack(*compactDoc);
+    size_t limit = min(store.maxSize(), (size_t)SNAPSHOT_MAX_SIZE);
+    if (len > limit) {
+        Serial.println("Snapshot of " + String(len) + " bytes exceeds the " + String(limit) + " byte store limit, skipping write");
+        return 0;
+    }
+    return serializeMsgPack(*compactDoc, buffer, SNAPSHOT_MAX_SIZE);
+}
+
+uint32_t SnapshotManager::hash(const uint8_t* data, size_t len) {
+    // FNV-1a
+    uint32_t value = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        value ^= data[i];
+        value *= 16777619u;
+    }
+    return value;
+}
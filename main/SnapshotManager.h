@@ -0,0 +1,40 @@
+#ifndef SNAPSHOT_MANAGER_H
+#define SNAPSHOT_MANAGER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include "MemoryPool.h"
+#include "SensorData.h"
+#include "SnapshotStore.h"
+
+// Keeps a compact MessagePack copy of the dashboard in persistent storage so it can be rebuilt
+// right after boot: the latest CustomMetadata, from whichever source sent it, plus the sensors
+// of every source merged the way the display shows them. The snapshot has the shape of a frame.
+// Writes are rate limited and skipped when the content did not change.
+class SnapshotManager {
+public:
+    SnapshotManager(SnapshotStore& store);
+    bool begin();
+    void setMetadata(JsonObjectConst metadata); // Call for every frame that carries CustomMetadata
+    void record(const std::vector<SourceSensors>& sources, bool layoutChanged); // Call after each applied live frame
+    bool load(JsonDocument& doc);
+    uint32_t getWriteCount() const;
+
+private:
+    SnapshotStore& store;
+    PsramJsonDocument* compactDoc; // Allocated in begin(), once PSRAM is available
+    PsramJsonDocument* metadataDoc; // Latest CustomMetadata, nothing is recorded before one arrived
+    uint8_t* buffer;
+    uint32_t savedHash;
+    uint32_t lastWriteMs;
+    uint32_t writeCount;
+    bool layoutPending;
+    bool written;
+    bool skipped; // Last attempt did not fit the store, retried at the layout interval
+
+    size_t serializeCompact(const std::vector<SourceSensors>& sources);
+    static uint32_t hash(const uint8_t* data, size_t len);
+};
+
+#endif // SNAPSHOT_MANAGER_H
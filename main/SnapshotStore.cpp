@@ -0,0 +1,35 @@
+#include "SnapshotStore.h"
+#include <stdio.h>
+
+FileSnapshotStore::FileSnapshotStore(const char* path) : path(path) {}
+
+bool FileSnapshotStore::begin() {
+    return true;
+}
+
+size_t FileSnapshotStore::read(uint8_t* buffer, size_t maxLen) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return 0;
+    }
+    size_t len = fread(buffer, 1, maxLen, file);
+    bool truncated = fgetc(file) != EOF; // A snapshot larger than the buffer is unusable
+    fclose(file);
+    return truncated ? 0 : len;
+}
+
+bool FileSnapshotStore::write(const uint8_t* data, size_t len) {
+    // Write to a temporary file first so a power cut never leaves a half-written snapshot
+    String tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = fwrite(data, 1, len, file) == len;
+    written = fclose(file) == 0 && written;
+    if (!written) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return rename(tempPath.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,28 @@
+#ifndef SNAPSHOT_STORE_H
+#define SNAPSHOT_STORE_H
+
+#include <Arduino.h>
+
+// Persistent storage for one snapshot blob. NVS on the device (NvsSnapshotStore.h); the
+// file-backed store keeps the same contract so the snapshot logic can be exercised on a host.
+class SnapshotStore {
+public:
+    virtual ~SnapshotStore() {}
+    virtual bool begin() = 0;
+    virtual size_t read(uint8_t* buffer, size_t maxLen) = 0; // Returns 0 when nothing is stored
+    virtual bool write(const uint8_t* data, size_t len) = 0;
+    virtual size_t maxSize() const { return SIZE_MAX; } // Larger snapshots are skipped
+};
+
+class FileSnapshotStore : public SnapshotStore {
+public:
+    FileSnapshotStore(const char* path);
+    bool begin() override;
+    size_t read(uint8_t* buffer, size_t maxLen) override;
+    bool write(const uint8_t* data, size_t len) override;
+
+private:
+    String path;
+};
+
+#endif // SNAPSHOT_STORE_H
@@ -0,0 +1,194 @@
+#include "ValueTweener.h"
+
+#define Q8_SHIFT 8
+#define EASE_SHIFT 2 // Move 1/4 of the remaining distance per tick
+
+ValueTweener::ValueTweener()
+    : timer(nullptr), periodMs(0), chartInvalidator(nullptr), chartValues(nullptr), movingCount(0) {}
+
+void ValueTweener::setFrameRate(int fps) {
+    uint32_t period = fps > 0 ? 1000 / fps : 0;
+    if (period == periodMs) {
+        return;
+    }
+    periodMs = period;
+
+    if (periodMs == 0) {
+        if (timer != nullptr) {
+            lv_timer_del(timer);
+            timer = nullptr;
+        }
+        // Keep the bindings, the next target after re-enabling snaps to its value
+        for (Tween& tween : bars) {
+            tween.moving = false;
+            tween.initialized = false;
+        }
+        for (Tween& tween : arcs) {
+            tween.moving = false;
+            tween.initialized = false;
+        }
+        movingCount = 0;
+        return;
+    }
+
+    if (timer == nullptr) {
+        timer = lv_timer_create(timerCallback, periodMs, this);
+        lv_timer_pause(timer);
+    } else {
+        lv_timer_set_period(timer, periodMs);
+    }
+}
+
+bool ValueTweener::isEnabled() const {
+    return periodMs > 0;
+}
+
+void ValueTweener::clear() {
+    bars.clear();
+    arcs.clear();
+    chartValues = nullptr;
+    movingCount = 0;
+    if (timer != nullptr) {
+        lv_timer_pause(timer);
+    }
+}
+
+void ValueTweener::setChartInvalidator(ChartInvalidator invalidator) {
+    chartInvalidator = invalidator;
+}
+
+void ValueTweener::bindChart(lv_coord_t* values, size_t count) {
+    for (const Tween& tween : bars) {
+        if (tween.moving) {
+            movingCount--;
+        }
+    }
+    chartValues = values;
+    bars.assign(count, Tween{nullptr, 0, 0, false, false});
+}
+
+void ValueTweener::setBarTarget(size_t index, int32_t value) {
+    if (chartValues == nullptr || index >= bars.size()) {
+        return;
+    }
+
+    Tween& tween = bars[index];
+    if (!tween.initialized) {
+        // New bars appear at their value instead of growing from zero
+        chartValues[index] = value;
+        if (chartInvalidator) {
+            chartInvalidator(index, index);
+        }
+    }
+    setTarget(tween, value);
+}
+
+void ValueTweener::setArcTarget(size_t index, lv_obj_t* arc, int32_t value) {
+    if (index >= arcs.size()) {
+        arcs.resize(index + 1, Tween{nullptr, 0, 0, false, false});
+    }
+
+    Tween& tween = arcs[index];
+    if (tween.arc != arc) {
+        if (tween.moving) {
+            movingCount--;
+        }
+        tween = Tween{arc, 0, 0, false, false};
+    }
+    if (!tween.initialized) {
+        lv_arc_set_value(arc, value);
+    }
+    setTarget(tween, value);
+}
+
+void ValueTweener::snapArcs() {
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        snapArc(i);
+    }
+}
+
+void ValueTweener::snapArc(size_t index) {
+    if (index >= arcs.size()) {
+        return;
+    }
+    Tween& tween = arcs[index];
+    if (tween.moving) {
+        movingCount--;
+    }
+    tween.moving = false;
+    tween.initialized = false;
+}
+
+void ValueTweener::setTarget(Tween& tween, int32_t value) {
+    int32_t target = value << Q8_SHIFT;
+    if (!tween.initialized) {
+        tween.current = target;
+        tween.target = target;
+        tween.initialized = true;
+        return;
+    }
+    if (target == tween.target) {
+        return;
+    }
+
+    tween.target = target;
+    if (!tween.moving) {
+        tween.moving = true;
+        movingCount++;
+        if (timer != nullptr) {
+            lv_timer_resume(timer);
+        }
+    }
+}
+
+bool ValueTweener::step(Tween& tween) {
+    int32_t before = (tween.current + (1 << (Q8_SHIFT - 1))) >> Q8_SHIFT;
+    int32_t delta = tween.target - tween.current;
+    int32_t move = delta >> EASE_SHIFT;
+    if (move == 0 || (delta > 0 ? delta : -delta) < (1 << Q8_SHIFT)) {
+        move = delta; // Within one unit: snap and settle
+    }
+    tween.current += move;
+
+    if (tween.current == tween.target) {
+        tween.moving = false;
+        movingCount--;
+    }
+    int32_t after = (tween.current + (1 << (Q8_SHIFT - 1))) >> Q8_SHIFT;
+    return after != before;
+}
+
+void ValueTweener::tick() {
+    size_t firstBar = bars.size();
+    size_t lastBar = 0;
+    for (size_t i = 0; i < bars.size(); ++i) {
+        Tween& tween = bars[i];
+        if (tween.moving && step(tween)) {
+            chartValues[i] = (tween.current + (1 << (Q8_SHIFT - 1))) >> Q8_SHIFT;
+            if (firstBar == bars.size()) {
+                firstBar = i;
+            }
+            lastBar = i;
+        }
+    }
+    if (firstBar < bars.size() && chartInvalidator) {
+        chartInvalidator(firstBar, lastBar); // One invalidation for all bars that moved this tick
+    }
+
+    for (Tween& tween : arcs) {
+        if (tween.moving && step(tween)) {
+            lv_arc_set_value(tween.arc, (tween.current + (1 << (Q8_SHIFT - 1))) >> Q8_SHIFT);
+        }
+    }
+
+    if (movingCount == 0) {
+        lv_timer_pause(timer); // Everything settled, no wakeups until a new target arrives
+    }
+}
+
+void ValueTweener::timerCallback(lv_timer_t* timer) {
+    ValueTweener* instance = (ValueTweener*)timer->user_data;
+    if (instance != nullptr) {
+        instance->tick();
+    }
+}
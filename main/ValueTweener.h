@@ -0,0 +1,50 @@
+#ifndef VALUE_TWEENER_H
+#define VALUE_TWEENER_H
+
+#include <lvgl.h>
+#include <functional>
+#include <vector>
+
+// Eases arc values and chart bars toward their latest target on an LVGL timer, so motion stays
+// smooth while data arrives at 1-2 Hz. Values are Q8 fixed point; each tick covers a quarter of
+// the remaining distance. Only widgets whose displayed integer value changes are touched, and the
+// timer pauses once everything has settled.
+class ValueTweener {
+public:
+    typedef std::function<void(size_t first, size_t last)> ChartInvalidator;
+
+    ValueTweener();
+    void setFrameRate(int fps); // 0 disables tweening
+    bool isEnabled() const;
+    void clear(); // Call when the tweened widgets are deleted
+    void setChartInvalidator(ChartInvalidator invalidator);
+    void bindChart(lv_coord_t* values, size_t count); // Bar chart y array, rebind when it is reallocated
+    void setBarTarget(size_t index, int32_t value);
+    void setArcTarget(size_t index, lv_obj_t* arc, int32_t value);
+    void snapArcs(); // The arcs show other sensors now, their next targets apply without easing
+    void snapArc(size_t index); // Same for one arc
+
+private:
+    struct Tween {
+        lv_obj_t* arc;   // nullptr for chart bars
+        int32_t current; // Q8
+        int32_t target;  // Q8
+        bool moving;
+        bool initialized;
+    };
+
+    lv_timer_t* timer;
+    uint32_t periodMs;
+    ChartInvalidator chartInvalidator;
+    lv_coord_t* chartValues;
+    std::vector<Tween> bars;
+    std::vector<Tween> arcs;
+    size_t movingCount;
+
+    void setTarget(Tween& tween, int32_t value);
+    bool step(Tween& tween); // Returns true when the displayed value changed
+    void tick();
+    static void timerCallback(lv_timer_t* timer);
+};
+
+#endif // VALUE_TWEENER_H
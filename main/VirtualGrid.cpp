@@ -0,0 +1,150 @@
+#include "VirtualGrid.h"
+
+#define CELL_TEXT_BUFFER_SIZE 96
+
+VirtualGrid::VirtualGrid()
+    : parent(nullptr), rows(0), cols(0), alertEngine(nullptr), source(nullptr), page(0), pageTimer(nullptr) {}
+
+void VirtualGrid::build(lv_obj_t* gridParent, int gridRows, int gridCols, int cellPadding, lv_style_t* labelStyle) {
+    reset();
+    parent = gridParent;
+    rows = gridRows;
+    cols = gridCols;
+
+    // The descriptor arrays must outlive the grid, so they are kept as members
+    colDsc.assign(cols + 1, LV_GRID_FR(1));
+    colDsc[cols] = LV_GRID_TEMPLATE_LAST;
+    rowDsc.assign(rows + 1, LV_GRID_FR(1));
+    rowDsc[rows] = LV_GRID_TEMPLATE_LAST;
+    lv_obj_set_grid_dsc_array(parent, colDsc.data(), rowDsc.data());
+
+    size_t cellCount = rows * cols;
+    cells.reserve(cellCount);
+    labels.reserve(cellCount);
+    for (size_t i = 0; i < cellCount; ++i) {
+        int row = i / cols;
+        int col = i % cols;
+
+        lv_obj_t* cell = lv_obj_create(parent);
+        lv_obj_set_grid_cell(cell, LV_GRID_ALIGN_STRETCH, col, 1, LV_GRID_ALIGN_STRETCH, row, 1);
+        lv_obj_set_style_bg_color(cell, lv_color_black(), 0);
+        lv_obj_set_style_pad_all(cell, cellPadding, 0);
+        lv_obj_set_style_border_color(cell, lv_color_black(), 0); // Set border color to black
+        lv_obj_set_style_border_width(cell, 1, 0); // Set border width
+        lv_obj_set_scrollbar_mode(cell, LV_SCROLLBAR_MODE_OFF); // Disable scrollbars
+        lv_obj_add_flag(cell, LV_OBJ_FLAG_HIDDEN); // Shown once a sensor is bound
+
+        lv_obj_t* label = lv_label_create(cell);
+        lv_label_set_text_static(label, "");
+        lv_obj_add_style(label, labelStyle, 0); // Shared font and text color
+        lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0); // Center text alignment
+        lv_obj_align(label, LV_ALIGN_CENTER, 0, 0); // Center the label within the cell
+
+        cells.push_back(cell);
+        labels.push_back(label);
+        alertStyles.push_back(nullptr);
+    }
+}
+
+void VirtualGrid::setAlertEngine(const AlertEngine* engine) {
+    alertEngine = engine;
+}
+
+void VirtualGrid::reset() {
+    if (pageTimer != nullptr) {
+        lv_timer_del(pageTimer);
+        pageTimer = nullptr;
+    }
+    parent = nullptr;
+    cells.clear();
+    labels.clear();
+    alertStyles.clear();
+    source = nullptr;
+    page = 0;
+}
+
+void VirtualGrid::bind(const std::vector<SensorData>& collection) {
+    source = &collection;
+    if (cells.empty()) {
+        return;
+    }
+
+    if (page >= pageCount()) {
+        page = 0;
+    }
+
+    // Only the sensors on the visible page are touched, off-screen ones are bound when paged in
+    char text[CELL_TEXT_BUFFER_SIZE];
+    size_t first = page * cells.size();
+    for (size_t i = 0; i < cells.size(); ++i) {
+        size_t sensorIndex = first + i;
+        if (sensorIndex >= collection.size()) {
+            lv_obj_add_flag(cells[i], LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+
+        const SensorData& sensor = collection[sensorIndex];
+        snprintf(text, sizeof(text), "%s\n%s", sensor.tag.c_str(), sensor.value.c_str());
+        if (strcmp(lv_label_get_text(labels[i]), text) != 0) {
+            lv_label_set_text(labels[i], text);
+        }
+
+        // Swap shared alert styles only when the cell's alert state differs from what is shown
+        lv_style_t* alertStyle = alertEngine != nullptr ? alertEngine->styleFor(sensor.alertSlot) : nullptr;
+        if (alertStyle != alertStyles[i]) {
+            if (alertStyles[i] != nullptr) {
+                lv_obj_remove_style(labels[i], alertStyles[i], 0);
+            }
+            if (alertStyle != nullptr) {
+                lv_obj_add_style(labels[i], alertStyle, 0);
+            }
+            alertStyles[i] = alertStyle;
+        }
+        lv_obj_clear_flag(cells[i], LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+void VirtualGrid::clearAlertStyles() {
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (alertStyles[i] != nullptr) {
+            lv_obj_remove_style(labels[i], alertStyles[i], 0);
+            alertStyles[i] = nullptr;
+        }
+    }
+}
+
+void VirtualGrid::setPaging(int fixedPage, uint32_t intervalMs) {
+    if (pageTimer != nullptr) {
+        lv_timer_del(pageTimer);
+        pageTimer = nullptr;
+    }
+
+    if (fixedPage >= 0) {
+        page = fixedPage; // Clamped against the collection on the next bind
+    } else if (intervalMs > 0) {
+        pageTimer = lv_timer_create(pageTimerCallback, intervalMs, this);
+    }
+}
+
+void VirtualGrid::nextPage() {
+    size_t pages = pageCount();
+    if (pages <= 1 || source == nullptr) {
+        return;
+    }
+    page = (page + 1) % pages;
+    bind(*source);
+}
+
+size_t VirtualGrid::pageCount() const {
+    if (cells.empty() || source == nullptr || source->empty()) {
+        return 1;
+    }
+    return (source->size() + cells.size() - 1) / cells.size();
+}
+
+void VirtualGrid::pageTimerCallback(lv_timer_t* timer) {
+    VirtualGrid* instance = (VirtualGrid*)timer->user_data;
+    if (instance != nullptr) {
+        instance->nextPage();
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef VIRTUAL_GRID_H
+#define VIRTUAL_GRID_H
+
+#include <lvgl.h>
+#include <vector>
+#include "SensorData.h"
+#include "AlertEngine.h"
+
+// Fixed rows x cols grid of sensor cells. Only one widget set per visible cell is ever
+// created; larger collections are split into pages and bound into the cells on demand.
+class VirtualGrid {
+public:
+    VirtualGrid();
+    void build(lv_obj_t* parent, int rows, int cols, int cellPadding, lv_style_t* labelStyle);
+    void setAlertEngine(const AlertEngine* engine);
+    void reset(); // Forget the widgets, call before the parent is deleted
+    void bind(const std::vector<SensorData>& collection);
+    void clearAlertStyles(); // Detach every alert style, the next bind applies the current ones
+    void setPaging(int fixedPage, uint32_t intervalMs); // fixedPage < 0 rotates every intervalMs
+    void nextPage();
+    size_t pageCount() const;
+
+private:
+    lv_obj_t* parent;
+    int rows;
+    int cols;
+    std::vector<lv_obj_t*> cells;
+    std::vector<lv_obj_t*> labels;
+    std::vector<lv_style_t*> alertStyles; // Alert style currently added to each label
+    const AlertEngine* alertEngine;
+    std::vector<lv_coord_t> colDsc;
+    std::vector<lv_coord_t> rowDsc;
+    const std::vector<SensorData>* source; // Collection last bound, used when the page rotates
+    size_t page;
+    lv_timer_t* pageTimer;
+
+    static void pageTimerCallback(lv_timer_t* timer);
+};
+
+#endif // VIRTUAL_GRID_H
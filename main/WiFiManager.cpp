@@ -1,25 +1,135 @@
 #include "WiFiManager.h"
+#include "MemoryPool.h"
 #include <ArduinoJson.h>
 #include <lvgl.h>
+#include <memory>
+
+#define DEFAULT_CAPTURE_SIZE (1024 * 1024)
+#define SERIAL_SOURCE "serial"
+#define MAX_SOURCE_LENGTH 24
 
 const char* WiFiManager::ssid = "ssid";
 const char* WiFiManager::password = "password";
 
 WiFiManager::WiFiManager() 
-    : server(80), jsonBuffer(""), payloadLength(0), readingLength(true), bytesRead(0), dataCallback(nullptr) {}
+    : server(80), dataCallback(nullptr), sourceStatsProvider(nullptr), framesReceived(0),
+      screenshotWidth(0), screenshotHeight(0), screenshotReader(nullptr) {}
 
 void WiFiManager::init() {
     connectToWiFi();
 
     // Initialize server
-    server.on("/data", HTTP_POST, [](AsyncWebServerRequest *request){
+    server.on("/data", HTTP_POST, [this](AsyncWebServerRequest *request){
+        pendingRequests.erase(request); // A frame never continues into the next request
         request->send(200, "text/plain", "Data received");
     }, nullptr, [this](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-        handleIncomingDataChunk(data, len);
+        capture.record(data, len, index == 0 ? FRAME_CAPTURE_FLAG_REQUEST_START : 0);
+        handleRequestChunk(request, data, len, index);
     });
+    registerCaptureRoutes();
+    registerScreenshotRoute();
     server.begin();
 }
 
+bool WiFiManager::startCapture(size_t capacity) {
+    return capture.begin(capacity);
+}
+
+void WiFiManager::registerCaptureRoutes() {
+    server.on("/capture/start", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        size_t capacity = DEFAULT_CAPTURE_SIZE;
+        if (request->hasParam("size")) {
+            capacity = request->getParam("size")->value().toInt();
+        }
+        if (capacity == 0 || capacity > FRAME_CAPTURE_MAX_SIZE) {
+            request->send(400, "text/plain", "size must be between 1 and " + String(FRAME_CAPTURE_MAX_SIZE));
+            return;
+        }
+        if (capture.isReading()) {
+            request->send(409, "text/plain", "Capture download in progress");
+            return;
+        }
+        if (startCapture(capacity)) {
+            request->send(200, "text/plain", "Capture started");
+        } else {
+            request->send(500, "text/plain", "Capture buffer allocation failed");
+        }
+    });
+
+    server.on("/capture/stop", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        capture.stop();
+        request->send(200, "text/plain", "Capture stopped");
+    });
+
+    // Streams the ring buffer without copying it, recording pauses until the download ends
+    server.on("/capture", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        size_t total = capture.beginRead();
+        AsyncWebServerResponse *response = request->beginResponse("application/octet-stream", total,
+            [this](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                size_t len = capture.read(buffer, maxLen, index);
+                if (len == 0) {
+                    capture.endRead();
+                }
+                return len;
+            });
+        response->addHeader("Content-Disposition", "attachment; filename=\"capture.jrcap\"");
+        request->onDisconnect([this]() {
+            capture.endRead();
+        });
+        request->send(response);
+    });
+
+    // Counters and memory figures polled by the replay tool
+    server.on("/stats", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        MemoryPoolStats pool = lvglPool.getStats();
+        String json = "{\"framesReceived\":" + String(framesReceived.load()) +
+                      ",\"freeHeap\":" + String(ESP.getFreeHeap()) +
+                      ",\"minFreeHeap\":" + String(ESP.getMinFreeHeap()) +
+                      ",\"freePsram\":" + String(ESP.getFreePsram()) +
+                      ",\"poolSramInUse\":" + String(pool.sramInUse) +
+                      ",\"poolSramHighWater\":" + String(pool.sramHighWater) +
+                      ",\"poolPsramInUse\":" + String(pool.psramInUse) +
+                      ",\"fragmentationPercent\":" + String(pool.fragmentationPercent) +
+                      ",\"captureBytes\":" + String(capture.getUsed()) +
+                      ",\"captureDropped\":" + String(capture.getDroppedRecords());
+        if (sourceStatsProvider) {
+            json += ",\"ingest\":" + sourceStatsProvider();
+        }
+        json += "}";
+        request->send(200, "application/json", json);
+    });
+}
+
+void WiFiManager::setScreenshotSource(int width, int height, ScreenshotEncoder::RowReader reader) {
+    screenshotWidth = width;
+    screenshotHeight = height;
+    screenshotReader = reader;
+}
+
+void WiFiManager::registerScreenshotRoute() {
+    // Encodes straight from the framebuffer one row at a time, ?format=rle for run-length output
+    server.on("/screenshot", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!screenshotReader) {
+            request->send(503, "text/plain", "Screenshot source not set");
+            return;
+        }
+
+        bool rle = request->hasParam("format") && request->getParam("format")->value() == "rle";
+        std::shared_ptr<ScreenshotEncoder> encoder = std::make_shared<ScreenshotEncoder>(
+            screenshotWidth, screenshotHeight,
+            rle ? ScreenshotEncoder::FORMAT_RLE : ScreenshotEncoder::FORMAT_BMP, screenshotReader);
+        AwsResponseFiller filler = [encoder](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return encoder->read(buffer, maxLen);
+        };
+
+        AsyncWebServerResponse *response = rle
+            ? request->beginChunkedResponse("application/octet-stream", filler)
+            : request->beginResponse("image/bmp", encoder->totalSize(), filler);
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response);
+    });
+}
+
 void WiFiManager::connectToWiFi() {
     WiFi.begin(ssid, password);
     int attempts = 0;
@@ -51,75 +161,66 @@ void WiFiManager::updateWiFiStatusLabel(lv_obj_t* label) {
     }
 }
 
-void WiFiManager::handleIncomingDataChunk(uint8_t *data, size_t len) {
-    if (data == nullptr || len == 0) {
-        Serial.println("Error: Incoming data is null or empty.");
-        return;
+void WiFiManager::handleRequestChunk(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index) {
+    auto found = pendingRequests.find(request);
+    if (found == pendingRequests.end()) {
+        if (index != 0) {
+            return; // The request was already dropped, ignore the rest of its body
+        }
+        found = pendingRequests.emplace(request, PendingRequest()).first;
+        found->second.source = sourceFor(request);
+        request->onDisconnect([this, request]() {
+            pendingRequests.erase(request);
+        });
     }
 
-    if (readingLength) {
-        // Check the first byte of the incoming data
-        char firstByte = data[0];
-        if (firstByte == '{') {
-            // If the data starts with '{', it indicates that there's no prefix length
-            Serial.println("Data without prefix length detected. Responding 'ok'.");
-            jsonBuffer = ""; // Clear buffer
-            readingLength = true; // Stay in reading length mode
-            bytesRead = 0; // Reset bytes read
-            return;
-        }
+    if (found->second.assembler.feed(data, len)) {
+        deliverFrame(found->second.source, found->second.assembler);
+    }
+}
 
-        // If the first byte is a number, assume the data includes a length prefix
-        if (isdigit(firstByte)) {
-            jsonBuffer += String((char*)data).substring(0, len);
-            bytesRead += len;
-
-            if (jsonBuffer.length() >= 8) {
-                payloadLength = jsonBuffer.substring(0, 8).toInt(); // Convert the length prefix to an integer
-                Serial.print("Length Prefix Detected: ");
-                Serial.println(payloadLength);
-                jsonBuffer = jsonBuffer.substring(8); // Remove the length prefix from the buffer
-                readingLength = false; // Switch to reading the payload
-            }
-        }
-    } else {
-        // Append the data chunk to the buffer
-        jsonBuffer += String((char*)data).substring(0, len);
-        bytesRead += len;
-
-        if (bytesRead >= payloadLength) {
-            Serial.println("WiFiManager Processed Inbound Data");
-            if (dataCallback) {
-                dataCallback(jsonBuffer);
-            }
-
-            // Process the JSON data
-            DynamicJsonDocument doc(1024);
-            DeserializationError error = deserializeJson(doc, jsonBuffer);
-
-            if (error) {
-                Serial.print("deserializeJson() failed: ");
-                Serial.println(error.c_str());
-            } else {
-                // Successfully processed JSON data
-                Serial.println("JSON data processed successfully.");
-            }
-
-            // Clear buffer and reset states for next message
-            jsonBuffer = "";
-            readingLength = true;
-            bytesRead = 0;
-        }
+String WiFiManager::sourceFor(AsyncWebServerRequest *request) {
+    // ?source=name or an X-Source header, otherwise the sender's address
+    String source;
+    if (request->hasParam("source")) {
+        source = request->getParam("source")->value();
+    } else if (request->hasHeader("X-Source")) {
+        source = request->header("X-Source");
+    }
+    source.replace(":", "_"); // ':' separates the source from the sensor tag
+    source.replace("\"", "_"); // Ids are echoed unescaped in /stats
+    source.replace("\\", "_");
+    if (source.isEmpty()) {
+        source = request->client()->remoteIP().toString();
+    }
+    if (source.length() > MAX_SOURCE_LENGTH) {
+        source = source.substring(0, MAX_SOURCE_LENGTH);
+    }
+    return source;
+}
+
+void WiFiManager::deliverFrame(const String& source, FrameAssembler& assembler) {
+    Serial.println("WiFiManager Processed Inbound Data");
+    framesReceived++;
+    String frame = assembler.take();
+    if (dataCallback) {
+        dataCallback(source, frame);
     }
 }
 
 void WiFiManager::handleSerialData() {
     while (Serial.available() > 0) {
-        char incomingByte = Serial.read();
-        handleIncomingDataChunk((uint8_t*)&incomingByte, 1);
+        uint8_t incomingByte = Serial.read();
+        if (serialAssembler.feed(&incomingByte, 1)) {
+            deliverFrame(SERIAL_SOURCE, serialAssembler);
+        }
     }
 }
 
-void WiFiManager::setDataCallback(std::function<void(const String&)> callback) {
+void WiFiManager::setDataCallback(std::function<void(const String& source, const String& json)> callback) {
     dataCallback = callback;
 }
+
+void WiFiManager::setSourceStatsProvider(std::function<String()> provider) {
+    sourceStatsProvider = provider;
+}
@@ -5,28 +5,49 @@
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 #include <lvgl.h>
+#include <atomic>
 #include <functional>
+#include <map>
+#include "FrameAssembler.h"
+#include "FrameCapture.h"
+#include "ScreenshotEncoder.h"
 
 class WiFiManager {
 public:
     WiFiManager();
     void init();
     void updateWiFiStatusLabel(lv_obj_t* label);
-    void handleIncomingDataChunk(uint8_t *data, size_t len);
     void handleSerialData();
-    void setDataCallback(std::function<void(const String&)> callback); // Setter for data callback
+    void setDataCallback(std::function<void(const String& source, const String& json)> callback); // Setter for data callback
+    void setSourceStatsProvider(std::function<String()> provider); // JSON object appended to /stats as "ingest"
+    bool startCapture(size_t capacity); // Records raw inbound HTTP chunks for download at /capture
+    void setScreenshotSource(int width, int height, ScreenshotEncoder::RowReader reader); // Enables /screenshot
 
 private:
     static const char* ssid;
     static const char* password;
     AsyncWebServer server;
-    String jsonBuffer;
-    int payloadLength; // Length of the payload
-    bool readingLength; // Flag to check if reading the length
-    int bytesRead; // Bytes read so far
-    std::function<void(const String&)> dataCallback; // Callback for handling data
+    struct PendingRequest {
+        String source;
+        FrameAssembler assembler;
+    };
+
+    std::map<AsyncWebServerRequest*, PendingRequest> pendingRequests; // Only touched on the async_tcp task
+    FrameAssembler serialAssembler; // Only touched on the loop task
+    std::function<void(const String& source, const String& json)> dataCallback; // Callback for handling data
+    std::function<String()> sourceStatsProvider;
+    FrameCapture capture;
+    std::atomic<uint32_t> framesReceived; // Counted on the async_tcp task and, for serial, the loop task
+    int screenshotWidth;
+    int screenshotHeight;
+    ScreenshotEncoder::RowReader screenshotReader;
 
     void connectToWiFi();
+    void handleRequestChunk(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index);
+    void deliverFrame(const String& source, FrameAssembler& assembler);
+    static String sourceFor(AsyncWebServerRequest *request);
+    void registerCaptureRoutes();
+    void registerScreenshotRoute();
 };
 
 #endif // WIFI_MANAGER_H
@@ -1,53 +1,103 @@
 #include "DisplayManager.h"
 #include "WiFiManager.h"
+#include "LoopScheduler.h"
+#include "SnapshotManager.h"
+#include "NvsSnapshotStore.h"
+
+#define IDLE_TIMEOUT_MS 60000 // Dim the panel after this long without a frame
 
 WiFiManager wifiManager;
 DisplayManager displayManager;
+LoopScheduler loopScheduler;
+NvsSnapshotStore snapshotStore("junction");
+SnapshotManager snapshotManager(snapshotStore);
 
 lv_obj_t* wifiStatusLabel;
+bool wifiStatusOverlay = false; // Status shown over a restored dashboard until fresh data arrives
 
 void setup() {
     Serial.begin(115200); // Initialize serial communication for debugging
+    loopScheduler.init();
+    Serial.onReceive([]() {
+        loopScheduler.notify(); // Wake the loop when serial data arrives
+    });
 
     // Initialize display manager
     displayManager.init();
 
+    // Show the last dashboard right away, before the blocking WiFi connect
+    snapshotManager.begin();
+    displayManager.setSnapshotManager(&snapshotManager);
+    bool restored = displayManager.restoreSnapshot();
+    if (restored) {
+        lv_refr_now(NULL);
+    }
+
     // WiFi status label
-    wifiStatusLabel = lv_label_create(lv_scr_act());
+    wifiStatusOverlay = restored;
+    wifiStatusLabel = lv_label_create(restored ? lv_layer_top() : lv_scr_act());
     if (wifiStatusLabel) {
         lv_obj_set_style_text_color(wifiStatusLabel, lv_color_make(0xFF, 0xFF, 0x00), 0); // Yellow color
         lv_obj_set_style_text_font(wifiStatusLabel, &lv_font_montserrat_24, 0);
-        lv_obj_align(wifiStatusLabel, LV_ALIGN_CENTER, 0, 50); // Adjust position as needed
+        if (restored) {
+            lv_obj_align(wifiStatusLabel, LV_ALIGN_BOTTOM_MID, 0, -10);
+        } else {
+            lv_obj_align(wifiStatusLabel, LV_ALIGN_CENTER, 0, 50); // Adjust position as needed
+        }
     } else {
         Serial.println("Error: Failed to create wifiStatusLabel");
     }
 
+    wifiManager.setScreenshotSource(displayManager.screenWidth(), displayManager.screenHeight(),
+        [](int y, uint16_t* row) {
+            displayManager.readScreenRow(y, row);
+        });
     wifiManager.init();
     wifiManager.updateWiFiStatusLabel(wifiStatusLabel);
 
     // Set the data callback to pass the JSON data to the display manager
-    wifiManager.setDataCallback([&](const String& jsonBuffer) {
-        // Process the received JSON
-        DynamicJsonDocument doc(8192);
-        DeserializationError error = deserializeJson(doc, jsonBuffer);
-
-        if (error) {
-            displayManager.logMessage(LOG_LEVEL_ERROR, "deserializeJson() failed");
-            displayManager.logMessage(LOG_LEVEL_ERROR, error.c_str());
-        } else {
-            // Log the parsed JSON for debugging
-            displayManager.logMessage(LOG_LEVEL_DEBUG, "JSON parsed successfully");
-
-            // Handle the incoming JSON data
-            displayManager.handleIncomingData(jsonBuffer);
-        }
+    wifiManager.setDataCallback([&](const String& source, const String& jsonBuffer) {
+        // Runs on the web server task, the frame is handled by loop() where LVGL lives
+        loopScheduler.postFrame(source, jsonBuffer);
+    });
+    wifiManager.setSourceStatsProvider([]() {
+        return loopScheduler.sourceStatsJson();
     });
 
     // Create home screen
-    displayManager.createHomeScreen(); // Ensure home screen is created on startup
+    if (!restored) {
+        displayManager.createHomeScreen(); // Ensure home screen is created on startup
+    }
 }
 
 void loop() {
-    lv_task_handler(); // Handle LVGL tasks
+    uint32_t nextTimerMs = lv_timer_handler(); // Handle LVGL timers, returns ms until the next one is due
     wifiManager.handleSerialData(); // Use the method from WiFiManager to handle serial data
-}
\ No newline at end of file
+
+    String source;
+    String frame;
+    if (loopScheduler.takeFrame(source, frame)) {
+        // One frame per pass, sources take turns. Parsing happens once, in the display manager's reusable document
+        displayManager.setIdle(false);
+        displayManager.handleIncomingData(source, frame);
+        if (wifiStatusOverlay && wifiStatusLabel != nullptr) {
+            lv_obj_del(wifiStatusLabel);
+            wifiStatusLabel = nullptr;
+            wifiStatusOverlay = false;
+        }
+        return; // Let LVGL render the new frame before sleeping
+    }
+
+    if (loopScheduler.msSinceLastFrame() > IDLE_TIMEOUT_MS) {
+        displayManager.setIdle(true);
+    }
+
+    float busyPercent;
+    if (loopScheduler.pollUtilization(busyPercent)) {
+        String report = "Loop CPU utilization: " + String(busyPercent, 1) + "%";
+        displayManager.logMessage(LOG_LEVEL_DEBUG, report.c_str());
+    }
+
+    // Sleep until LVGL needs to run again or a frame, serial data or input wakes us
+    loopScheduler.waitForWork(nextTimerMs);
+}
@@ -0,0 +1,101 @@
+// Alert slots and rule matching: colliding hashes must never share a slot or a rule, and the
+// slots of sources that stopped sending are reused.
+#include "AlertEngine.h"
+#include "SensorModel.h"
+#include <string>
+
+#define SOURCE_EXPIRY_MS 60000
+
+static int failures = 0;
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                       \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+void compile(AlertEngine& engine, const char* rules) {
+    DynamicJsonDocument doc(2048);
+    CHECK(!deserializeJson(doc, rules));
+    engine.compile(doc.as<JsonArrayConst>());
+}
+
+void testCollidingKeysGetTheirOwnSlots() {
+    // "pc:Fan pogz" and "pc:Fan rsved" have the same 32-bit FNV-1a hash
+    AlertEngine engine;
+    uint16_t first = engine.slotFor("pc", "Fan pogz", "Fan", "Motherboard");
+    uint16_t second = engine.slotFor("pc", "Fan rsved", "Fan", "Motherboard");
+    CHECK(first != ALERT_NO_SLOT);
+    CHECK(second != ALERT_NO_SLOT);
+    CHECK(first != second);
+    CHECK(engine.slotFor("pc", "Fan pogz", "Fan", "Motherboard") == first);
+    CHECK(engine.slotFor("pc", "Fan rsved", "Fan", "Motherboard") == second);
+    CHECK(engine.slotCount() == 2);
+}
+
+void testTagRuleComparesTheTag() {
+    // "Sensor 422382" and "Sensor 639599" have the same 32-bit FNV-1a hash
+    AlertEngine engine;
+    compile(engine, "[{\"Tag\":\"Sensor 422382\",\"Above\":50,\"Color\":\"#FF0000\"}]");
+    uint16_t matching = engine.slotFor("pc", "Sensor 422382", "", "");
+    uint16_t colliding = engine.slotFor("pc", "Sensor 639599", "", "");
+    CHECK(engine.update(matching, 99));
+    CHECK(engine.styleFor(matching) != nullptr);
+    CHECK(!engine.update(colliding, 99));
+    CHECK(engine.styleFor(colliding) == nullptr);
+}
+
+void testReleasedSlotsAreReused() {
+    AlertEngine engine;
+    compile(engine, "[{\"Category\":\"Load\",\"Above\":90}]");
+    uint16_t slot = engine.slotFor("10.0.0.1", "CPU Core #1", "Load", "CPU");
+    engine.slotFor("10.0.0.1", "CPU Core #2", "Load", "CPU");
+    CHECK(engine.update(slot, 95));
+    CHECK(engine.slotCount() == 2);
+
+    engine.releaseSource("10.0.0.1");
+    CHECK(engine.slotCount() == 0);
+    CHECK(engine.styleFor(slot) == nullptr);
+    CHECK(!engine.update(slot, 99)); // Released slots have no rule
+
+    // The next sources take over the freed slots, with fresh state
+    uint16_t reused = engine.slotFor("10.0.0.2", "CPU Core #1", "Load", "CPU");
+    uint16_t reusedToo = engine.slotFor("10.0.0.2", "CPU Core #2", "Load", "CPU");
+    CHECK(reused < 2 && reusedToo < 2 && reused != reusedToo);
+    CHECK(engine.styleFor(reused) == nullptr);
+    CHECK(engine.update(reused, 95));
+    CHECK(engine.slotCount() == 2);
+}
+
+void testExpiredSourcesFreeTheirSlots() {
+    // Address-derived source ids change as hosts come and go; only live sources hold slots
+    SensorModel model;
+    DynamicJsonDocument doc(2048);
+    const char* frame = "{\"sensors\":{\"CPU Core #1\":[{\"Value\":10,\"Unit\":\"%\",\"SensorOrder\":0}],"
+                        "\"CPU Core #2\":[{\"Value\":12,\"Unit\":\"%\",\"SensorOrder\":1}]}}";
+    for (int i = 0; i < 500; ++i) {
+        setMillis(i * (SOURCE_EXPIRY_MS + 1));
+        CHECK(!deserializeJson(doc, frame));
+        model.apply(String("10.0.") + String(i / 256) + "." + String(i % 256), doc);
+    }
+    CHECK(model.sourceSensors.size() == 1);
+    CHECK(model.alertEngine.slotCount() == 2);
+    setMillis(0);
+}
+
+}
+
+int main() {
+    testCollidingKeysGetTheirOwnSlots();
+    testTagRuleComparesTheTag();
+    testReleasedSlotsAreReused();
+    testExpiredSourcesFreeTheirSlots();
+    if (failures == 0) {
+        printf("AlertEngineTest passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+// Flush throughput per display profile: renders full frames strip by strip into the profile's
+// draw buffers and flushes each strip through a host flush callback, the way LVGL drives
+// my_disp_flush. With two buffers the flush runs on its own thread, standing in for the DMA
+// transfer that overlaps rendering of the next strip on the device.
+//   DisplayProfileBench [--frames N]
+#include "DisplayProfile.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#define DEFAULT_FRAMES 30
+
+namespace {
+
+// 480x272 panels use the same bus timings, only the geometry differs
+template <uint16_t Lines, uint8_t Count, DrawBufferPlacement Placement>
+using CrowPanel7 = DisplayProfile<800, 480, CrowPanel7Timing, Lines, Count, Placement>;
+
+template <uint16_t Lines, uint8_t Count, DrawBufferPlacement Placement>
+using Panel43 = DisplayProfile<480, 272, CrowPanel7Timing, Lines, Count, Placement>;
+
+// Copies a strip into the frame with the byte swap pushColors(..., true) does on the device
+class HostPanel {
+public:
+    HostPanel(int width, int height) : width(width), frame((size_t)width * height) {}
+
+    void flush(const lv_area_t& area, const lv_color_t* pixels) {
+        int stripWidth = area.x2 - area.x1 + 1;
+        for (int y = area.y1; y <= area.y2; ++y) {
+            uint16_t* out = &frame[(size_t)y * width + area.x1];
+            for (int x = 0; x < stripWidth; ++x) {
+                uint16_t color = pixels->full;
+                out[x] = (uint16_t)((color << 8) | (color >> 8));
+                pixels++;
+            }
+        }
+    }
+
+    uint32_t checksum() const {
+        uint32_t sum = 0;
+        for (uint16_t pixel : frame) {
+            sum = sum * 31 + pixel;
+        }
+        return sum;
+    }
+
+private:
+    int width;
+    std::vector<uint16_t> frame;
+};
+
+// Runs flushes on a worker thread and reports each buffer free again, like lv_disp_flush_ready
+class AsyncFlusher {
+public:
+    explicit AsyncFlusher(HostPanel& panel) : panel(panel), pending(nullptr), stopping(false) {
+        worker = std::thread(&AsyncFlusher::run, this);
+    }
+
+    ~AsyncFlusher() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        changed.notify_all();
+        worker.join();
+    }
+
+    void start(const lv_area_t& area, const lv_color_t* pixels) {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this] { return pending == nullptr; }); // One flush in flight at a time
+        pendingArea = area;
+        pending = pixels;
+        changed.notify_all();
+    }
+
+    void waitIdle() {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this] { return pending == nullptr; });
+    }
+
+private:
+    HostPanel& panel;
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable changed;
+    lv_area_t pendingArea;
+    const lv_color_t* pending;
+    bool stopping;
+
+    void run() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            changed.wait(guard, [this] { return pending != nullptr || stopping; });
+            if (pending == nullptr) {
+                return;
+            }
+            lv_area_t area = pendingArea;
+            const lv_color_t* pixels = pending;
+            guard.unlock();
+            panel.flush(area, pixels);
+            guard.lock();
+            pending = nullptr;
+            changed.notify_all();
+        }
+    }
+};
+
+// Stands in for LVGL drawing a strip: a gradient that changes every frame
+void renderStrip(lv_color_t* buffer, int width, int firstLine, int lines, int frame) {
+    for (int y = 0; y < lines; ++y) {
+        for (int x = 0; x < width; ++x) {
+            buffer->full = (uint16_t)((x + frame) * 0x0841 + (firstLine + y));
+            buffer++;
+        }
+    }
+}
+
+template <typename Profile>
+uint32_t benchmark(const char* panelName, int frames) {
+    std::vector<std::vector<lv_color_t>> buffers(Profile::bufferCount, std::vector<lv_color_t>(Profile::bufferPixels));
+    HostPanel panel(Profile::width, Profile::height);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t flushes = 0;
+    {
+        AsyncFlusher flusher(panel);
+        size_t active = 0;
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int y = 0; y < Profile::height; y += Profile::bufferLines) {
+                int lines = Profile::height - y < Profile::bufferLines ? Profile::height - y : Profile::bufferLines;
+                lv_area_t area = {0, (lv_coord_t)y, (lv_coord_t)(Profile::width - 1), (lv_coord_t)(y + lines - 1)};
+
+                if (Profile::bufferCount == 1) {
+                    renderStrip(buffers[0].data(), Profile::width, y, lines, frame);
+                    panel.flush(area, buffers[0].data()); // Single buffer: rendering waits for the flush
+                } else {
+                    // The buffer being filled was handed out two strips ago, start() waits for that flush
+                    renderStrip(buffers[active].data(), Profile::width, y, lines, frame);
+                    flusher.start(area, buffers[active].data());
+                    active ^= 1;
+                }
+                flushes++;
+            }
+        }
+        flusher.waitIdle();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double pixels = (double)Profile::width * Profile::height * frames;
+    printf("%-8s %4u lines x%u %-5s %7zu KiB  %6.1f flushes/frame  %8.1f Mpx/s  %6.1f frames/s  (%08x)\n",
+           panelName, (unsigned)Profile::bufferLines, (unsigned)Profile::bufferCount,
+           Profile::placement == DRAW_BUFFER_PSRAM ? "PSRAM" : "SRAM", Profile::totalBufferBytes / 1024,
+           (double)flushes / frames, pixels / seconds / 1e6, frames / seconds, panel.checksum());
+    return panel.checksum();
+}
+
+}
+
+int main(int argc, char** argv) {
+    int frames = DEFAULT_FRAMES;
+    if (argc == 3 && strcmp(argv[1], "--frames") == 0) {
+        frames = atoi(argv[2]) > 0 ? atoi(argv[2]) : 1;
+    }
+
+    // Line counts up to what the SRAM budget allows for one and two buffers, then PSRAM.
+    // Every configuration of a panel must leave the same image behind.
+    uint32_t crowPanel7[] = {
+        benchmark<CrowPanel7<10, 1, DRAW_BUFFER_SRAM>>("800x480", frames),
+        benchmark<CrowPanel7<20, 1, DRAW_BUFFER_SRAM>>("800x480", frames),
+        benchmark<CrowPanel7<40, 1, DRAW_BUFFER_SRAM>>("800x480", frames),
+        benchmark<CrowPanel7<60, 1, DRAW_BUFFER_SRAM>>("800x480", frames),
+        benchmark<CrowPanel7<10, 2, DRAW_BUFFER_SRAM>>("800x480", frames),
+        benchmark<CrowPanel7<30, 2, DRAW_BUFFER_SRAM>>("800x480", frames),
+        benchmark<CrowPanel7<120, 2, DRAW_BUFFER_PSRAM>>("800x480", frames),
+        benchmark<CrowPanel7<480, 1, DRAW_BUFFER_PSRAM>>("800x480", frames),
+    };
+    uint32_t panel43[] = {
+        benchmark<Panel43<10, 1, DRAW_BUFFER_SRAM>>("480x272", frames),
+        benchmark<Panel43<50, 1, DRAW_BUFFER_SRAM>>("480x272", frames),
+        benchmark<Panel43<50, 2, DRAW_BUFFER_SRAM>>("480x272", frames),
+        benchmark<Panel43<272, 2, DRAW_BUFFER_PSRAM>>("480x272", frames),
+    };
+
+    bool consistent = true;
+    for (uint32_t checksum : crowPanel7) {
+        consistent = consistent && checksum == crowPanel7[0];
+    }
+    for (uint32_t checksum : panel43) {
+        consistent = consistent && checksum == panel43[0];
+    }
+    if (!consistent) {
+        fprintf(stderr, "Flushed frames differ between buffer configurations\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Per-connection frame assembly: several senders whose chunks arrive interleaved must each
+// produce their own intact frames.
+#include "FrameAssembler.h"
+#include <string>
+#include <vector>
+
+#define SENDERS 4
+#define FRAMES_PER_SENDER 200
+
+static int failures = 0;
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                       \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+uint32_t nextRandom(uint32_t& state) {
+    // xorshift32, deterministic across runs
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+std::string makePayload(int sender, int frame, uint32_t& state) {
+    std::string payload = "{\"sensors\":{\"sender" + std::to_string(sender) + "\":[{\"Value\":\"" +
+                          std::to_string(frame) + "\",\"Pad\":\"";
+    payload.append(nextRandom(state) % 600, (char)('a' + sender));
+    return payload + "\"}]}}";
+}
+
+std::string withPrefix(const std::string& payload) {
+    // The length counts the 8-digit prefix itself
+    char prefix[9];
+    snprintf(prefix, sizeof(prefix), "%08zu", payload.size() + 8);
+    return prefix + payload;
+}
+
+// Feeds exactly len bytes from a heap copy, so reads past the chunk are caught by sanitizers
+bool feedChunk(FrameAssembler& assembler, const std::string& bytes, size_t offset, size_t len) {
+    std::vector<uint8_t> chunk(bytes.begin() + offset, bytes.begin() + offset + len);
+    return assembler.feed(chunk.data(), chunk.size());
+}
+
+struct Sender {
+    FrameAssembler assembler;
+    std::vector<std::string> payloads;
+    std::string wire; // Current frame with its prefix
+    size_t sent;
+    int next;
+    int received;
+};
+
+void testInterleavedSenders() {
+    uint32_t state = 88172645u;
+    Sender senders[SENDERS];
+    for (int s = 0; s < SENDERS; ++s) {
+        for (int f = 0; f < FRAMES_PER_SENDER; ++f) {
+            senders[s].payloads.push_back(makePayload(s, f, state));
+        }
+        senders[s].wire = withPrefix(senders[s].payloads[0]);
+        senders[s].sent = 0;
+        senders[s].next = 0;
+        senders[s].received = 0;
+    }
+
+    // Random sender, random chunk size: chunks of all senders interleave arbitrarily
+    int active = SENDERS;
+    while (active > 0) {
+        Sender& sender = senders[nextRandom(state) % SENDERS];
+        if (sender.next == FRAMES_PER_SENDER) {
+            continue;
+        }
+
+        size_t len = std::min((size_t)(1 + nextRandom(state) % 97), sender.wire.size() - sender.sent);
+        bool complete = feedChunk(sender.assembler, sender.wire, sender.sent, len);
+        sender.sent += len;
+        if (complete) {
+            String frame = sender.assembler.take();
+            CHECK(sender.sent == sender.wire.size()); // Never completes early
+            CHECK(std::string(frame.c_str()) == sender.payloads[sender.next]);
+            sender.received++;
+        }
+        if (sender.sent == sender.wire.size()) {
+            if (++sender.next == FRAMES_PER_SENDER) {
+                active--;
+            } else {
+                sender.wire = withPrefix(sender.payloads[sender.next]);
+                sender.sent = 0;
+            }
+        }
+    }
+
+    for (int s = 0; s < SENDERS; ++s) {
+        CHECK(senders[s].received == FRAMES_PER_SENDER);
+    }
+}
+
+void testSingleChunkFrame() {
+    // An HTTP body usually arrives as one chunk holding the prefix and the whole payload
+    uint32_t state = 1u;
+    std::string payload = makePayload(0, 0, state);
+    std::string wire = withPrefix(payload);
+    FrameAssembler assembler;
+    CHECK(feedChunk(assembler, wire, 0, wire.size()));
+    CHECK(std::string(assembler.take().c_str()) == payload);
+}
+
+void testSerialBytes() {
+    // Serial delivers one byte at a time
+    uint32_t state = 2u;
+    FrameAssembler assembler;
+    for (int f = 0; f < 3; ++f) {
+        std::string payload = makePayload(1, f, state);
+        std::string wire = withPrefix(payload);
+        for (size_t i = 0; i < wire.size(); ++i) {
+            bool complete = feedChunk(assembler, wire, i, 1);
+            CHECK(complete == (i + 1 == wire.size()));
+        }
+        CHECK(std::string(assembler.take().c_str()) == payload);
+    }
+}
+
+void testUnprefixedFrameIsDropped() {
+    FrameAssembler assembler;
+    std::string json = "{\"sensors\":{}}";
+    CHECK(!feedChunk(assembler, json, 0, json.size()));
+
+    // The next prefixed frame still comes through intact
+    std::string wire = withPrefix("{\"ok\":1}");
+    CHECK(feedChunk(assembler, wire, 0, wire.size()));
+    CHECK(std::string(assembler.take().c_str()) == "{\"ok\":1}");
+}
+
+}
+
+int main() {
+    testInterleavedSenders();
+    testSingleChunkFrame();
+    testSerialBytes();
+    testUnprefixedFrameIsDropped();
+    if (failures == 0) {
+        printf("FrameAssemblerTest passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+// Soak and concurrency checks for the LVGL size-class pool: a million simulated frames must
+// leave the heap exactly where the warm-up left it.
+#include "MemoryPool.h"
+#include <esp_heap_caps.h>
+#include <thread>
+#include <vector>
+
+#define SOAK_FRAMES 1000000
+#define LONG_LIVED_OBJECTS 64
+#define ALLOCATIONS_PER_FRAME 16
+#define THREAD_ITERATIONS 200000
+#define SLAB_SIZE 4096 // Mirrors MemoryPool.cpp
+#define BLOCK_HEADER_SIZE 8
+
+static int failures = 0;
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                       \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+uint32_t nextRandom(uint32_t& state) {
+    // xorshift32, deterministic across runs
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+size_t randomSize(uint32_t& state) {
+    // Mostly small LVGL objects and strings, sometimes bulk buffers
+    uint32_t roll = nextRandom(state) % 100;
+    if (roll < 90) {
+        return 1 + nextRandom(state) % 256;
+    }
+    return 257 + nextRandom(state) % 4096;
+}
+
+void fill(void* ptr, size_t size, uint8_t pattern) {
+    memset(ptr, pattern, size);
+}
+
+bool holds(const void* ptr, size_t size, uint8_t pattern) {
+    const uint8_t* bytes = (const uint8_t*)ptr;
+    for (size_t i = 0; i < size; ++i) {
+        if (bytes[i] != pattern) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Allocation {
+    void* ptr;
+    size_t size;
+};
+
+void testSoak() {
+    MemoryPool pool;
+    uint32_t state = 2463534242u;
+    Allocation longLived[LONG_LIVED_OBJECTS] = {};
+    size_t halfwayHeap = 0;
+    size_t halfwaySlabs = 0;
+
+    for (uint32_t frame = 0; frame < SOAK_FRAMES; ++frame) {
+        // Per-frame churn: allocate, grow some, free everything
+        Allocation frameAllocations[ALLOCATIONS_PER_FRAME];
+        for (int i = 0; i < ALLOCATIONS_PER_FRAME; ++i) {
+            size_t size = randomSize(state);
+            void* ptr = pool.allocate(size);
+            if (ptr != nullptr && i % 4 == 0) {
+                size = randomSize(state);
+                ptr = pool.reallocate(ptr, size);
+            }
+            frameAllocations[i] = {ptr, size};
+        }
+        for (int i = 0; i < ALLOCATIONS_PER_FRAME; ++i) {
+            pool.deallocate(frameAllocations[i].ptr);
+        }
+
+        // A widget replaced every frame, like a label whose text changes
+        Allocation& slot = longLived[frame % LONG_LIVED_OBJECTS];
+        pool.deallocate(slot.ptr);
+        slot.size = randomSize(state);
+        slot.ptr = pool.allocate(slot.size);
+
+        if (frame == SOAK_FRAMES / 2) {
+            halfwayHeap = host_heap_bytes_in_use();
+            halfwaySlabs = pool.getStats().slabBytes;
+        }
+    }
+
+    MemoryPoolStats stats = pool.getStats();
+    CHECK(stats.allocFailures == 0);
+
+    // Slabs never exceed what the largest possible working set needs in every class
+    const size_t classSizes[] = {16, 32, 64, 128, 256};
+    const size_t maxLiveBlocks = LONG_LIVED_OBJECTS + ALLOCATIONS_PER_FRAME;
+    size_t slabBound = 0;
+    for (size_t size : classSizes) {
+        size_t blocksPerSlab = SLAB_SIZE / (BLOCK_HEADER_SIZE + size);
+        slabBound += (maxLiveBlocks + blocksPerSlab - 1) / blocksPerSlab * SLAB_SIZE;
+    }
+    CHECK(stats.slabBytes <= slabBound);
+
+    // The second half of the run adds nothing: no slabs, and only the long-lived set may differ
+    CHECK(stats.slabBytes == halfwaySlabs);
+    size_t heap = host_heap_bytes_in_use();
+    size_t longLivedBound = LONG_LIVED_OBJECTS * (BLOCK_HEADER_SIZE + 257 + 4096);
+    CHECK(heap <= halfwayHeap + longLivedBound && halfwayHeap <= heap + longLivedBound);
+
+    for (int i = 0; i < LONG_LIVED_OBJECTS; ++i) {
+        pool.deallocate(longLived[i].ptr);
+    }
+    stats = pool.getStats();
+    CHECK(stats.sramInUse == 0);
+    CHECK(stats.psramInUse == 0);
+    CHECK(host_heap_bytes_in_use() == stats.slabBytes); // Only the slabs themselves remain
+}
+
+void testConcurrentTasks() {
+    // Two tasks allocating and freeing at once, each block must keep its own pattern
+    MemoryPool pool;
+    std::vector<std::thread> tasks;
+    int corrupted[2] = {0, 0};
+    for (int t = 0; t < 2; ++t) {
+        tasks.push_back(std::thread([&pool, &corrupted, t]() {
+            uint32_t state = 12345u + t;
+            uint8_t pattern = (uint8_t)(0xA0 + t);
+            for (int i = 0; i < THREAD_ITERATIONS; ++i) {
+                size_t size = 1 + nextRandom(state) % 256;
+                void* ptr = pool.allocate(size);
+                if (ptr == nullptr) {
+                    corrupted[t]++;
+                    continue;
+                }
+                fill(ptr, size, pattern);
+                if (!holds(ptr, size, pattern)) {
+                    corrupted[t]++;
+                }
+                pool.deallocate(ptr);
+            }
+        }));
+    }
+    for (std::thread& task : tasks) {
+        task.join();
+    }
+
+    CHECK(corrupted[0] == 0);
+    CHECK(corrupted[1] == 0);
+    MemoryPoolStats stats = pool.getStats();
+    CHECK(stats.sramInUse == 0);
+    CHECK(stats.allocFailures == 0);
+}
+
+void testForeignPointers() {
+    MemoryPool pool;
+    uint8_t foreign[64] = {};
+    CHECK(pool.reallocate(foreign + 8, 32) == nullptr);
+    pool.deallocate(foreign + 8); // Logged and ignored
+    CHECK(pool.getStats().sramInUse == 0);
+
+    // Growing across the class boundary moves the block and keeps its contents
+    void* ptr = pool.allocate(16);
+    fill(ptr, 16, 0x5A);
+    ptr = pool.reallocate(ptr, 2000);
+    CHECK(ptr != nullptr && holds(ptr, 16, 0x5A));
+    CHECK(pool.getStats().psramInUse == 2000);
+    pool.deallocate(ptr);
+    CHECK(pool.getStats().psramInUse == 0);
+}
+
+}
+
+int main() {
+    testSoak();
+    testConcurrentTasks();
+    testForeignPointers();
+    if (failures == 0) {
+        printf("MemoryPoolTest passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,276 @@
+// Replays a capture downloaded from the panel's /capture endpoint through the host build of the
+// ingest path: every chunk goes through a FrameAssembler, every completed frame through
+// deserializeJson and SensorModel::apply with millis() set to the chunk's capture timestamp.
+// Reports throughput, per-frame latency percentiles and heap use.
+//   _gate_build/ReplayCapture prod.jrcap --loops 10 --senders 4
+// Widget updates are not part of the host build; on the device they come on top of these figures.
+#include "FrameAssembler.h"
+#include "MemoryPool.h"
+#include "SensorModel.h"
+#include <esp_heap_caps.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#define JSON_DOCUMENT_CAPACITY 8192 // As DisplayManager allocates it
+#define CAPTURE_MAGIC "JRCAP1\0\0"
+#define CAPTURE_MAGIC_LENGTH 8
+#define CAPTURE_RECORD_HEADER_LENGTH 12
+#define CAPTURE_FLAG_REQUEST_START 0x0001
+#define LOOP_GAP_MS 1000 // Between the end of one pass over the capture and the start of the next
+
+namespace {
+
+// Everything the host build allocates through new, the document pool goes through heap_caps
+size_t heapInUse = 0;
+size_t heapPeak = 0;
+
+struct AllocationHeader {
+    size_t size;
+    size_t padding; // Keeps the payload 16-byte aligned
+};
+
+struct Record {
+    uint32_t timestampMs;
+    uint16_t flags;
+    std::vector<uint8_t> data;
+};
+
+struct Sender {
+    String source;
+    FrameAssembler assembler;
+    double pendingSeconds; // Assembly time of the frame in progress
+};
+
+struct Totals {
+    size_t frames;
+    size_t failures;
+    size_t bytes;
+    double assembleSeconds;
+    double parseSeconds;
+    double applySeconds;
+    std::vector<double> latencies;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+uint32_t readLittleEndian(const uint8_t* data, int bytes) {
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+bool loadCapture(const char* path, std::vector<Record>& records) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t block[4096];
+    size_t len;
+    while ((len = fread(block, 1, sizeof(block), file)) > 0) {
+        bytes.insert(bytes.end(), block, block + len);
+    }
+    fclose(file);
+
+    if (bytes.size() < CAPTURE_MAGIC_LENGTH || memcmp(bytes.data(), CAPTURE_MAGIC, CAPTURE_MAGIC_LENGTH) != 0) {
+        fprintf(stderr, "%s: not a capture file\n", path);
+        return false;
+    }
+
+    size_t offset = CAPTURE_MAGIC_LENGTH;
+    while (offset + CAPTURE_RECORD_HEADER_LENGTH <= bytes.size()) {
+        Record record;
+        record.timestampMs = readLittleEndian(&bytes[offset], 4);
+        record.flags = readLittleEndian(&bytes[offset + 4], 2);
+        uint32_t length = readLittleEndian(&bytes[offset + 8], 4);
+        offset += CAPTURE_RECORD_HEADER_LENGTH;
+        if (offset + length > bytes.size()) {
+            fprintf(stderr, "%s: last record is truncated, ignored\n", path);
+            break;
+        }
+        record.data.assign(bytes.begin() + offset, bytes.begin() + offset + length);
+        offset += length;
+        records.push_back(record);
+    }
+    return true;
+}
+
+void applyFrame(SensorModel& model, JsonDocument& doc, Sender& sender, Totals& totals) {
+    String frame = sender.assembler.take();
+    Clock::time_point start = Clock::now();
+    DeserializationError error = deserializeJson(doc, frame);
+    double parseSeconds = secondsSince(start);
+    if (error) {
+        fprintf(stderr, "frame %zu from %s: deserializeJson() failed: %s\n", totals.frames + totals.failures,
+                sender.source.c_str(), error.c_str());
+        totals.failures++;
+        sender.pendingSeconds = 0;
+        return;
+    }
+
+    start = Clock::now();
+    model.apply(sender.source, doc);
+    double applySeconds = secondsSince(start);
+
+    totals.frames++;
+    totals.bytes += frame.length();
+    totals.assembleSeconds += sender.pendingSeconds;
+    totals.parseSeconds += parseSeconds;
+    totals.applySeconds += applySeconds;
+    totals.latencies.push_back(sender.pendingSeconds + parseSeconds + applySeconds);
+    sender.pendingSeconds = 0;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t index = std::min(sorted.size() - 1, (size_t)(fraction * sorted.size()));
+    return sorted[index];
+}
+
+void usage() {
+    fprintf(stderr, "usage: ReplayCapture <capture.jrcap> [--loops N] [--senders N]\n");
+}
+
+}
+
+void* operator new(size_t size) {
+    AllocationHeader* header = (AllocationHeader*)malloc(sizeof(AllocationHeader) + size);
+    if (header == nullptr) {
+        throw std::bad_alloc();
+    }
+    header->size = size;
+    heapInUse += size;
+    heapPeak = std::max(heapPeak, heapInUse);
+    return header + 1;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    AllocationHeader* header = (AllocationHeader*)ptr - 1;
+    heapInUse -= header->size;
+    free(header);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    int loops = 1;
+    int senderCount = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loops = std::max(atoi(argv[++i]), 1);
+        } else if (strcmp(argv[i], "--senders") == 0 && i + 1 < argc) {
+            senderCount = std::max(atoi(argv[++i]), 1);
+        } else if (argv[i][0] != '-' && path == nullptr) {
+            path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (path == nullptr) {
+        usage();
+        return 2;
+    }
+
+    std::vector<Record> records;
+    if (!loadCapture(path, records)) {
+        return 1;
+    }
+
+    // The ring may start mid-request when old records were dropped, the panel never saw that
+    // request's prefix either
+    size_t first = 0;
+    while (first < records.size() && !(records[first].flags & CAPTURE_FLAG_REQUEST_START)) {
+        first++;
+    }
+    if (first == records.size()) {
+        fprintf(stderr, "%s: capture contains no requests\n", path);
+        return 1;
+    }
+    if (first > 0) {
+        printf("skipped %zu chunks before the first request start\n", first);
+    }
+    uint32_t captureStartMs = records[first].timestampMs;
+    uint32_t captureSpanMs = records.back().timestampMs - captureStartMs;
+
+    Totals totals = {0, 0, 0, 0, 0, 0, std::vector<double>()};
+    totals.latencies.reserve((records.size() - first) * loops * senderCount);
+
+    size_t baselineHeap = heapInUse;
+    SensorModel* model = new SensorModel();
+    PsramJsonDocument* doc = new PsramJsonDocument(JSON_DOCUMENT_CAPACITY);
+
+    // With several senders every request is replayed once per sender under its own source id,
+    // their chunks interleaved the way concurrent connections arrive
+    std::vector<Sender*> senders;
+    for (int i = 0; i < senderCount; ++i) {
+        Sender* sender = new Sender();
+        sender->source = senderCount > 1 ? String("replay") + String(i) : String("replay");
+        sender->pendingSeconds = 0;
+        senders.push_back(sender);
+    }
+
+    Clock::time_point runStart = Clock::now();
+    for (int loop = 0; loop < loops; ++loop) {
+        uint32_t loopOffsetMs = loop * (captureSpanMs + LOOP_GAP_MS);
+        for (size_t i = first; i < records.size(); ++i) {
+            const Record& record = records[i];
+            setMillis(record.timestampMs - captureStartMs + loopOffsetMs);
+            for (Sender* sender : senders) {
+                Clock::time_point start = Clock::now();
+                if (record.flags & CAPTURE_FLAG_REQUEST_START) {
+                    sender->assembler.reset(); // Every request gets a fresh assembler on the panel
+                    sender->pendingSeconds = 0;
+                }
+                bool complete = sender->assembler.feed(record.data.data(), record.data.size());
+                sender->pendingSeconds += secondsSince(start);
+                if (complete) {
+                    applyFrame(*model, *doc, *sender, totals);
+                }
+            }
+        }
+    }
+    double elapsed = secondsSince(runStart);
+
+    size_t sourceCount = model->sourceSensors.size();
+    size_t sensorCount = 0;
+    for (const SourceSensors& entry : model->sourceSensors) {
+        sensorCount += entry.sensors.size();
+    }
+
+    printf("frames: %zu ok, %zu failed in %.3f s (capture span %.1f s x %d loops, %d senders)\n", totals.frames,
+           totals.failures, elapsed, captureSpanMs / 1000.0, loops, senderCount);
+    if (totals.frames > 0) {
+        std::vector<double>& latencies = totals.latencies;
+        std::sort(latencies.begin(), latencies.end());
+        printf("throughput: %.1f frames/s, %.1f KiB/s\n", totals.frames / elapsed, totals.bytes / elapsed / 1024);
+        printf("latency us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n", 1e6 * percentile(latencies, 0.5),
+               1e6 * percentile(latencies, 0.9), 1e6 * percentile(latencies, 0.99), 1e6 * latencies.back());
+        printf("per frame us: assemble %.1f  parse %.1f  apply %.1f\n", 1e6 * totals.assembleSeconds / totals.frames,
+               1e6 * totals.parseSeconds / totals.frames, 1e6 * totals.applySeconds / totals.frames);
+    }
+    printf("heap: json pool %.1f KiB (%zu bytes used of the last frame), peak %.1f KiB, in use %.1f KiB for %zu sources, %zu sensors and %zu alert slots\n",
+           host_heap_bytes_in_use() / 1024.0, doc->memoryUsage(), (heapPeak - baselineHeap) / 1024.0,
+           (heapInUse - baselineHeap) / 1024.0, sourceCount, sensorCount, model->alertEngine.slotCount());
+
+    for (Sender* sender : senders) {
+        delete sender;
+    }
+    delete doc;
+    delete model;
+    return totals.frames > 0 && totals.failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+// Golden checks for the screenshot encoder: a known RGB565 image must encode byte for byte to
+// the checked-in fixtures, whatever chunk size the HTTP filler asks for.
+#include "ScreenshotEncoder.h"
+#include <stdio.h>
+#include <vector>
+
+#define IMAGE_WIDTH 7 // Odd, so BMP rows carry two bytes of padding
+#define IMAGE_HEIGHT 5
+
+static int failures = 0;
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                       \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+// Even rows are red/green/blue bands (long runs), odd rows change every pixel (runs of one)
+// and the last row is a single white run. The fixtures were written independently from this
+// description, not by the encoder.
+uint16_t pixel(int x, int y) {
+    if (y == IMAGE_HEIGHT - 1) {
+        return 0xFFFF;
+    }
+    if (y % 2 == 0) {
+        return x < 3 ? 0xF800 : (x < 6 ? 0x07E0 : 0x001F);
+    }
+    return (uint16_t)(x * 0x0841 + y);
+}
+
+void readRow(int y, uint16_t* row) {
+    for (int x = 0; x < IMAGE_WIDTH; ++x) {
+        row[x] = pixel(x, y);
+    }
+}
+
+std::vector<uint8_t> loadFixture(const char* path) {
+    std::vector<uint8_t> data;
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "Cannot open fixture %s\n", path);
+        failures++;
+        return data;
+    }
+    uint8_t chunk[256];
+    size_t len;
+    while ((len = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + len);
+    }
+    fclose(file);
+    return data;
+}
+
+std::vector<uint8_t> encode(ScreenshotEncoder::Format format, size_t chunkSize) {
+    ScreenshotEncoder encoder(IMAGE_WIDTH, IMAGE_HEIGHT, format, readRow);
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> chunk(chunkSize);
+    size_t len;
+    while ((len = encoder.read(chunk.data(), chunk.size())) > 0) {
+        out.insert(out.end(), chunk.begin(), chunk.begin() + len);
+    }
+    return out;
+}
+
+void testFormat(ScreenshotEncoder::Format format, const char* fixturePath) {
+    std::vector<uint8_t> expected = loadFixture(fixturePath);
+    CHECK(!expected.empty());
+
+    // One byte at a time, sizes that split headers and rows, and everything at once
+    const size_t chunkSizes[] = {1, 3, 17, 64, 4096};
+    for (size_t chunkSize : chunkSizes) {
+        std::vector<uint8_t> actual = encode(format, chunkSize);
+        CHECK(actual == expected);
+    }
+
+    ScreenshotEncoder encoder(IMAGE_WIDTH, IMAGE_HEIGHT, format, readRow);
+    CHECK(encoder.totalSize() == (format == ScreenshotEncoder::FORMAT_BMP ? expected.size() : 0));
+}
+
+}
+
+int main() {
+    testFormat(ScreenshotEncoder::FORMAT_BMP, "fixtures/screenshot_7x5.bmp");
+    testFormat(ScreenshotEncoder::FORMAT_RLE, "fixtures/screenshot_7x5.rle");
+    if (failures == 0) {
+        printf("ScreenshotEncoderTest passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
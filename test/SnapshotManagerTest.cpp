@@ -0,0 +1,226 @@
+// Snapshot persistence against a file-backed store: what is written, when it is written and
+// when a write is skipped. The clock is the settable millis() of the Arduino stub.
+#include "SensorModel.h"
+#include "SnapshotManager.h"
+#include <string>
+#include <unistd.h>
+
+#define LAYOUT_WRITE_DELAY_MS 10000
+#define VALUE_WRITE_INTERVAL_MS 600000
+
+static int failures = 0;
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                       \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+// Accepts only small snapshots, like a store on a nearly full partition
+class SmallFileStore : public FileSnapshotStore {
+public:
+    SmallFileStore(const char* path) : FileSnapshotStore(path) {}
+    size_t maxSize() const override {
+        return 64;
+    }
+};
+
+std::string tempPath() {
+    char path[] = "/tmp/SnapshotManagerTestXXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        close(fd);
+        remove(path); // Each test starts without a stored snapshot
+    }
+    return path;
+}
+
+SensorData sensor(const char* tag, const char* value, int order, const char* category, const char* componentName) {
+    SensorData data = {tag, value, order, category, componentName, ALERT_NO_SLOT};
+    return data;
+}
+
+// One source's sensors as SensorModel keeps them, values already carry their unit
+std::vector<SourceSensors> sources(const char* cpuLoad) {
+    SourceSensors pc;
+    pc.source = "pc";
+    pc.lastSeenMs = 0;
+    pc.sensors.push_back(sensor("CPU Core #1", cpuLoad, 0, "Load", "CPU"));
+    pc.sensors.push_back(sensor("GPU Temperature", "64 C", 1, "Temperature", "GPU"));
+    return std::vector<SourceSensors>(1, pc);
+}
+
+void record(SnapshotManager& manager, int version, const char* cpuLoad, bool layoutChanged) {
+    DynamicJsonDocument metadata(512);
+    std::string json = "{\"Layout\":\"CPUDash\",\"ConfigVersion\":" + std::to_string(version) + "}";
+    CHECK(!deserializeJson(metadata, json.c_str()));
+    manager.setMetadata(metadata.as<JsonObjectConst>());
+    manager.record(sources(cpuLoad), layoutChanged);
+}
+
+void testRoundTrip() {
+    setMillis(0);
+    std::string path = tempPath();
+    FileSnapshotStore store(path.c_str());
+    SnapshotManager manager(store);
+    CHECK(manager.begin());
+    record(manager, 1, "42.5 %", true);
+    CHECK(manager.getWriteCount() == 1);
+
+    // A fresh manager, as after a reboot, reads back the layout and the fields the layouts use
+    SnapshotManager restored(store);
+    CHECK(restored.begin());
+    DynamicJsonDocument loaded(4096);
+    CHECK(restored.load(loaded));
+    CHECK(strcmp(loaded["metadata"]["CustomMetadata"]["Layout"] | "", "CPUDash") == 0);
+    CHECK(loaded["metadata"]["CustomMetadata"]["ConfigVersion"].as<int>() == 1);
+    JsonVariant cpu = loaded["sensors"]["CPU Core #1"][0];
+    CHECK(strcmp(cpu["Value"] | "", "42.5 %") == 0);
+    CHECK(cpu["Unit"].isNull()); // Folded into the value
+    CHECK(cpu["SensorOrder"].as<int>() == 0);
+    CHECK(strcmp(cpu["Category"] | "", "Load") == 0);
+    CHECK(strcmp(cpu["ComponentName"] | "", "CPU") == 0);
+    CHECK(loaded["sensors"]["GPU Temperature"][0]["SensorOrder"].as<int>() == 1);
+
+    // Applied like a frame, it shows what was on screen
+    SensorModel model;
+    model.apply(SNAPSHOT_SOURCE, loaded);
+    CHECK(model.cpuCollection.size() == 1 && model.cpuCollection[0].value == "42.5 %");
+    CHECK(model.otherCollection.size() == 1 && model.otherCollection[0].value == "64 C");
+    remove(path.c_str());
+}
+
+void testRateLimits() {
+    setMillis(0);
+    std::string path = tempPath();
+    FileSnapshotStore store(path.c_str());
+    SnapshotManager manager(store);
+    CHECK(manager.begin());
+    record(manager, 1, "10 %", true);
+    CHECK(manager.getWriteCount() == 1);
+
+    // A layout change waits for the layout delay
+    setMillis(LAYOUT_WRITE_DELAY_MS - 1);
+    record(manager, 2, "11 %", true);
+    CHECK(manager.getWriteCount() == 1);
+    setMillis(LAYOUT_WRITE_DELAY_MS);
+    record(manager, 2, "12 %", false); // Still pending from the earlier frame
+    CHECK(manager.getWriteCount() == 2);
+
+    // Values alone wait for the value interval after the last write
+    setMillis(LAYOUT_WRITE_DELAY_MS + 1000);
+    record(manager, 2, "13 %", false);
+    CHECK(manager.getWriteCount() == 2);
+    setMillis(LAYOUT_WRITE_DELAY_MS + VALUE_WRITE_INTERVAL_MS - 1);
+    record(manager, 2, "14 %", false);
+    CHECK(manager.getWriteCount() == 2);
+    setMillis(LAYOUT_WRITE_DELAY_MS + VALUE_WRITE_INTERVAL_MS);
+    record(manager, 2, "15 %", false);
+    CHECK(manager.getWriteCount() == 3);
+
+    DynamicJsonDocument loaded(4096);
+    CHECK(manager.load(loaded));
+    CHECK(strcmp(loaded["sensors"]["CPU Core #1"][0]["Value"] | "", "15 %") == 0);
+    remove(path.c_str());
+}
+
+void testIdenticalContentSkipped() {
+    setMillis(0);
+    std::string path = tempPath();
+    FileSnapshotStore store(path.c_str());
+    SnapshotManager manager(store);
+    CHECK(manager.begin());
+    record(manager, 1, "50 %", true);
+    CHECK(manager.getWriteCount() == 1);
+
+    // Due for a write, but nothing changed
+    setMillis(VALUE_WRITE_INTERVAL_MS);
+    record(manager, 1, "50 %", false);
+    CHECK(manager.getWriteCount() == 1);
+    setMillis(2 * VALUE_WRITE_INTERVAL_MS);
+    record(manager, 1, "51 %", false);
+    CHECK(manager.getWriteCount() == 2);
+    remove(path.c_str());
+}
+
+void testMergedSourcesSurviveReboot() {
+    setMillis(0);
+    std::string path = tempPath();
+    FileSnapshotStore store(path.c_str());
+    SnapshotManager manager(store);
+    CHECK(manager.begin());
+
+    // Sensors alone are not recorded until some source sent the layout
+    std::vector<SourceSensors> merged = sources("30 %");
+    manager.record(merged, true);
+    CHECK(manager.getWriteCount() == 0);
+
+    // The layout comes from "pc", "laptop" only sends sensors
+    SourceSensors laptop;
+    laptop.source = "laptop";
+    laptop.lastSeenMs = 0;
+    laptop.sensors.push_back(sensor("CPU Core #1", "70 %", 0, "Load", "CPU"));
+    laptop.sensors.push_back(sensor("Battery", "80 %", 1, "Battery", "Laptop"));
+    merged.push_back(laptop);
+    DynamicJsonDocument metadata(512);
+    CHECK(!deserializeJson(metadata, "{\"Layout\":\"CPUDash\"}"));
+    manager.setMetadata(metadata.as<JsonObjectConst>());
+    manager.record(merged, true);
+    CHECK(manager.getWriteCount() == 1);
+
+    // After a reboot, both sources' sensors are back in the order they were shown
+    SnapshotManager restored(store);
+    CHECK(restored.begin());
+    DynamicJsonDocument loaded(4096);
+    CHECK(restored.load(loaded));
+    SensorModel model;
+    model.apply(SNAPSHOT_SOURCE, loaded);
+    CHECK(model.config.layout == LAYOUT_CPU_DASH);
+    CHECK(model.cpuCollection.size() == 2 && model.cpuCollection[0].tag == "pc:CPU Core #1" &&
+          model.cpuCollection[1].tag == "laptop:CPU Core #1" && model.cpuCollection[1].value == "70 %");
+    CHECK(model.otherCollection.size() == 2 && model.otherCollection[0].tag == "pc:GPU Temperature" &&
+          model.otherCollection[1].tag == "laptop:Battery");
+
+    // The restored layout carries on while only sensor-only sources report
+    setMillis(LAYOUT_WRITE_DELAY_MS);
+    restored.record(std::vector<SourceSensors>(1, laptop), true);
+    CHECK(restored.getWriteCount() == 1);
+    CHECK(restored.load(loaded));
+    CHECK(strcmp(loaded["metadata"]["CustomMetadata"]["Layout"] | "", "CPUDash") == 0);
+    CHECK(strcmp(loaded["sensors"]["Battery"][0]["Value"] | "", "80 %") == 0);
+    remove(path.c_str());
+}
+
+void testOversizeSkipped() {
+    setMillis(0);
+    std::string path = tempPath();
+    SmallFileStore store(path.c_str());
+    SnapshotManager manager(store);
+    CHECK(manager.begin());
+    record(manager, 1, "50 %", true);
+    CHECK(manager.getWriteCount() == 0);
+
+    // Nothing reached the store
+    DynamicJsonDocument loaded(4096);
+    CHECK(!manager.load(loaded));
+    CHECK(access(path.c_str(), F_OK) != 0);
+    remove(path.c_str());
+}
+
+}
+
+int main() {
+    testRoundTrip();
+    testRateLimits();
+    testIdenticalContentSkipped();
+    testMergedSourcesSurviveReboot();
+    testOversizeSkipped();
+    if (failures == 0) {
+        printf("SnapshotManagerTest passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
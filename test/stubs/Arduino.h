@@ -0,0 +1,147 @@
+// Minimal host stand-in for the Arduino core, only what the tested sources use
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <utility>
+
+using std::min;
+using std::max;
+
+// FreeRTOS spinlocks become a mutex, so concurrent tests still exercise the locking
+typedef std::recursive_mutex portMUX_TYPE;
+#define portMUX_INITIALIZE(mux) ((void)(mux))
+#define portENTER_CRITICAL(mux) ((mux)->lock())
+#define portEXIT_CRITICAL(mux) ((mux)->unlock())
+
+// The clock only moves when a test sets it
+inline uint32_t& hostMillis() {
+    static uint32_t now = 0;
+    return now;
+}
+
+inline uint32_t millis() {
+    return hostMillis();
+}
+
+inline void setMillis(uint32_t now) {
+    hostMillis() = now;
+}
+
+inline void* ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+class String {
+public:
+    String() {}
+    String(const char* text) : value(text != nullptr ? text : "") {}
+    String(const std::string& text) : value(text) {}
+    explicit String(char c) : value(1, c) {}
+    explicit String(int number) : value(std::to_string(number)) {}
+    explicit String(unsigned int number) : value(std::to_string(number)) {}
+    explicit String(long number) : value(std::to_string(number)) {}
+    explicit String(unsigned long number) : value(std::to_string(number)) {}
+
+    bool concat(const char* text, unsigned int length) {
+        value.append(text, length);
+        return true;
+    }
+    String& operator+=(const String& other) {
+        value += other.value;
+        return *this;
+    }
+    String& operator+=(const char* text) {
+        value += text;
+        return *this;
+    }
+    friend String operator+(const String& left, const String& right) {
+        return String(left.value + right.value);
+    }
+    friend String operator+(const String& left, const char* right) {
+        return String(left.value + right);
+    }
+    friend String operator+(const char* left, const String& right) {
+        return String(left + right.value);
+    }
+    bool operator==(const String& other) const {
+        return value == other.value;
+    }
+    bool operator==(const char* other) const {
+        return value == other;
+    }
+    bool operator!=(const String& other) const {
+        return value != other.value;
+    }
+    bool operator!=(const char* other) const {
+        return value != other;
+    }
+    bool operator<(const String& other) const {
+        return value < other.value;
+    }
+    bool startsWith(const String& prefix) const {
+        return value.compare(0, prefix.value.size(), prefix.value) == 0;
+    }
+    String substring(unsigned int from) const {
+        return from < value.size() ? String(value.substr(from)) : String();
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        return from < value.size() ? String(value.substr(from, to - from)) : String();
+    }
+    unsigned int length() const {
+        return value.size();
+    }
+    bool isEmpty() const {
+        return value.empty();
+    }
+    long toInt() const {
+        return atol(value.c_str());
+    }
+    float toFloat() const {
+        return atof(value.c_str());
+    }
+    const char* c_str() const {
+        return value.c_str();
+    }
+
+private:
+    std::string value;
+};
+
+class HostSerial {
+public:
+    void print(const char* text) {
+        fputs(text, stderr);
+    }
+    void print(const String& text) {
+        print(text.c_str());
+    }
+    void println(const char* text) {
+        fprintf(stderr, "%s\n", text);
+    }
+    void println(const String& text) {
+        println(text.c_str());
+    }
+    void println(long value) {
+        fprintf(stderr, "%ld\n", value);
+    }
+    void printf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        vfprintf(stderr, format, args);
+        va_end(args);
+    }
+};
+
+static HostSerial Serial __attribute__((unused));
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,2071 @@
+// Host stand-in for ArduinoJson 6, the subset the firmware uses: documents with a fixed
+// capacity, variants, objects and arrays with lazy member creation, JSON parsing and printing,
+// and MessagePack in both directions. Capacity is accounted with the 32-bit slot size, so a
+// document overflows on the host where it would on the device.
+#ifndef HOST_ARDUINO_JSON_H
+#define HOST_ARDUINO_JSON_H
+
+#include <Arduino.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define HOST_JSON_SLOT_SIZE 16 // sizeof(VariantSlot) on the ESP32
+#define HOST_JSON_NESTING_LIMIT 10
+
+class JsonDocument;
+class JsonVariant;
+class JsonVariantConst;
+class JsonObject;
+class JsonObjectConst;
+class JsonArray;
+class JsonArrayConst;
+
+namespace host_json {
+
+struct Node {
+    enum Type {
+        NUL,
+        BOOLEAN,
+        INTEGER,
+        REAL,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    Type type;
+    bool boolean;
+    int64_t integer;
+    double real;
+    std::string text;
+    std::vector<std::string> keys; // Object member names, parallel to items
+    std::vector<Node*> items;       // Array elements or object values
+
+    Node() : type(NUL), boolean(false), integer(0), real(0) {}
+
+    bool isNumber() const {
+        return type == INTEGER || type == REAL;
+    }
+
+    double number() const {
+        return type == INTEGER ? (double)integer : (type == REAL ? real : 0.0);
+    }
+
+    const Node* member(const char* key) const {
+        if (type != OBJECT || key == nullptr) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) {
+                return items[i];
+            }
+        }
+        return nullptr;
+    }
+
+    const Node* element(size_t index) const {
+        return type == ARRAY && index < items.size() ? items[index] : nullptr;
+    }
+
+    void reset() {
+        type = NUL;
+        boolean = false;
+        integer = 0;
+        real = 0;
+        text.clear();
+        keys.clear();
+        items.clear();
+    }
+};
+
+template <typename Writer>
+void writeBytes(Writer& writer, const char* data, size_t length) {
+    writer.write((const uint8_t*)data, length);
+}
+
+template <typename Writer>
+void writeJsonString(Writer& writer, const std::string& text) {
+    writeBytes(writer, "\"", 1);
+    for (char c : text) {
+        const char* escaped = nullptr;
+        switch (c) {
+            case '"': escaped = "\\\""; break;
+            case '\\': escaped = "\\\\"; break;
+            case '\b': escaped = "\\b"; break;
+            case '\f': escaped = "\\f"; break;
+            case '\n': escaped = "\\n"; break;
+            case '\r': escaped = "\\r"; break;
+            case '\t': escaped = "\\t"; break;
+            default: break;
+        }
+        if (escaped != nullptr) {
+            writeBytes(writer, escaped, 2);
+        } else if ((uint8_t)c < 0x20) {
+            char unicode[7];
+            snprintf(unicode, sizeof(unicode), "\\u%04x", (unsigned)(uint8_t)c);
+            writeBytes(writer, unicode, 6);
+        } else {
+            writeBytes(writer, &c, 1);
+        }
+    }
+    writeBytes(writer, "\"", 1);
+}
+
+inline std::string formatReal(double value) {
+    if (value != value || value == 1.0 / 0.0 || value == -1.0 / 0.0) {
+        return "null"; // JSON has no NaN or infinity
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", value);
+    return text;
+}
+
+template <typename Writer>
+void writeJson(Writer& writer, const Node* node) {
+    if (node == nullptr) {
+        writeBytes(writer, "null", 4);
+        return;
+    }
+    switch (node->type) {
+        case Node::NUL:
+            writeBytes(writer, "null", 4);
+            break;
+        case Node::BOOLEAN:
+            node->boolean ? writeBytes(writer, "true", 4) : writeBytes(writer, "false", 5);
+            break;
+        case Node::INTEGER: {
+            std::string text = std::to_string((long long)node->integer);
+            writeBytes(writer, text.data(), text.size());
+            break;
+        }
+        case Node::REAL: {
+            std::string text = formatReal(node->real);
+            writeBytes(writer, text.data(), text.size());
+            break;
+        }
+        case Node::STRING:
+            writeJsonString(writer, node->text);
+            break;
+        case Node::ARRAY:
+            writeBytes(writer, "[", 1);
+            for (size_t i = 0; i < node->items.size(); ++i) {
+                if (i > 0) {
+                    writeBytes(writer, ",", 1);
+                }
+                writeJson(writer, node->items[i]);
+            }
+            writeBytes(writer, "]", 1);
+            break;
+        case Node::OBJECT:
+            writeBytes(writer, "{", 1);
+            for (size_t i = 0; i < node->items.size(); ++i) {
+                if (i > 0) {
+                    writeBytes(writer, ",", 1);
+                }
+                writeJsonString(writer, node->keys[i]);
+                writeBytes(writer, ":", 1);
+                writeJson(writer, node->items[i]);
+            }
+            writeBytes(writer, "}", 1);
+            break;
+    }
+}
+
+struct StringWriter {
+    std::string text;
+
+    size_t write(uint8_t c) {
+        text += (char)c;
+        return 1;
+    }
+    size_t write(const uint8_t* data, size_t length) {
+        text.append((const char*)data, length);
+        return length;
+    }
+};
+
+// Writes into a fixed buffer and counts what did not fit, like ArduinoJson's buffer writers
+struct BufferWriter {
+    uint8_t* buffer;
+    size_t capacity;
+    size_t length;
+    size_t wanted;
+
+    size_t write(uint8_t c) {
+        return write(&c, 1);
+    }
+    size_t write(const uint8_t* data, size_t count) {
+        wanted += count;
+        size_t room = capacity - length;
+        size_t copied = count < room ? count : room;
+        if (buffer != nullptr && copied > 0) {
+            memcpy(buffer + length, data, copied);
+        }
+        length += copied;
+        return copied;
+    }
+};
+
+template <typename Writer>
+void writeMsgPackUint(Writer& writer, uint8_t marker, uint64_t value, int bytes) {
+    uint8_t out[9];
+    out[0] = marker;
+    for (int i = 0; i < bytes; ++i) {
+        out[1 + i] = (uint8_t)(value >> (8 * (bytes - 1 - i))); // Big-endian
+    }
+    writer.write(out, 1 + bytes);
+}
+
+template <typename Writer>
+void writeMsgPackLength(Writer& writer, size_t length, uint8_t fixMarker, size_t fixLimit, uint8_t marker8,
+                        uint8_t marker16, uint8_t marker32) {
+    if (length < fixLimit) {
+        uint8_t marker = fixMarker | (uint8_t)length;
+        writer.write(&marker, 1);
+    } else if (marker8 != 0 && length <= 0xFF) {
+        writeMsgPackUint(writer, marker8, length, 1);
+    } else if (length <= 0xFFFF) {
+        writeMsgPackUint(writer, marker16, length, 2);
+    } else {
+        writeMsgPackUint(writer, marker32, length, 4);
+    }
+}
+
+template <typename Writer>
+void writeMsgPackString(Writer& writer, const std::string& text) {
+    writeMsgPackLength(writer, text.size(), 0xA0, 32, 0xD9, 0xDA, 0xDB);
+    writeBytes(writer, text.data(), text.size());
+}
+
+template <typename Writer>
+void writeMsgPack(Writer& writer, const Node* node) {
+    if (node == nullptr || node->type == Node::NUL) {
+        uint8_t nil = 0xC0;
+        writer.write(&nil, 1);
+        return;
+    }
+    switch (node->type) {
+        case Node::BOOLEAN: {
+            uint8_t value = node->boolean ? 0xC3 : 0xC2;
+            writer.write(&value, 1);
+            break;
+        }
+        case Node::INTEGER: {
+            int64_t value = node->integer;
+            if (value >= 0 && value <= 0x7F) {
+                uint8_t fix = (uint8_t)value;
+                writer.write(&fix, 1);
+            } else if (value < 0 && value >= -32) {
+                uint8_t fix = (uint8_t)(int8_t)value;
+                writer.write(&fix, 1);
+            } else if (value > 0) {
+                if (value <= 0xFF) {
+                    writeMsgPackUint(writer, 0xCC, value, 1);
+                } else if (value <= 0xFFFF) {
+                    writeMsgPackUint(writer, 0xCD, value, 2);
+                } else if (value <= 0xFFFFFFFFLL) {
+                    writeMsgPackUint(writer, 0xCE, value, 4);
+                } else {
+                    writeMsgPackUint(writer, 0xCF, value, 8);
+                }
+            } else if (value >= -128) {
+                writeMsgPackUint(writer, 0xD0, (uint8_t)(int8_t)value, 1);
+            } else if (value >= -32768) {
+                writeMsgPackUint(writer, 0xD1, (uint16_t)(int16_t)value, 2);
+            } else if (value >= -2147483648LL) {
+                writeMsgPackUint(writer, 0xD2, (uint32_t)(int32_t)value, 4);
+            } else {
+                writeMsgPackUint(writer, 0xD3, (uint64_t)value, 8);
+            }
+            break;
+        }
+        case Node::REAL: {
+            float narrow = (float)node->real;
+            if ((double)narrow == node->real) {
+                uint32_t bits;
+                memcpy(&bits, &narrow, sizeof(bits));
+                writeMsgPackUint(writer, 0xCA, bits, 4);
+            } else {
+                uint64_t bits;
+                memcpy(&bits, &node->real, sizeof(bits));
+                writeMsgPackUint(writer, 0xCB, bits, 8);
+            }
+            break;
+        }
+        case Node::STRING:
+            writeMsgPackString(writer, node->text);
+            break;
+        case Node::ARRAY:
+            writeMsgPackLength(writer, node->items.size(), 0x90, 16, 0, 0xDC, 0xDD);
+            for (const Node* item : node->items) {
+                writeMsgPack(writer, item);
+            }
+            break;
+        case Node::OBJECT:
+            writeMsgPackLength(writer, node->items.size(), 0x80, 16, 0, 0xDE, 0xDF);
+            for (size_t i = 0; i < node->items.size(); ++i) {
+                writeMsgPackString(writer, node->keys[i]);
+                writeMsgPack(writer, node->items[i]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+class Parser;
+
+}
+
+class DeserializationError {
+public:
+    enum Code {
+        Ok,
+        EmptyInput,
+        IncompleteInput,
+        InvalidInput,
+        NoMemory,
+        TooDeep
+    };
+
+    DeserializationError() : errorCode(Ok) {}
+    DeserializationError(Code code) : errorCode(code) {}
+
+    explicit operator bool() const {
+        return errorCode != Ok;
+    }
+    bool operator==(Code code) const {
+        return errorCode == code;
+    }
+    bool operator!=(Code code) const {
+        return errorCode != code;
+    }
+    Code code() const {
+        return errorCode;
+    }
+    const char* c_str() const {
+        static const char* const names[] = {"Ok", "EmptyInput", "IncompleteInput", "InvalidInput", "NoMemory", "TooDeep"};
+        return names[errorCode];
+    }
+
+private:
+    Code errorCode;
+};
+
+class JsonString {
+public:
+    JsonString() : text(nullptr) {}
+    JsonString(const char* text) : text(text) {}
+
+    const char* c_str() const {
+        return text;
+    }
+    bool isNull() const {
+        return text == nullptr;
+    }
+    size_t size() const {
+        return text != nullptr ? strlen(text) : 0;
+    }
+    bool operator==(const char* other) const {
+        return text != nullptr && other != nullptr && strcmp(text, other) == 0;
+    }
+
+private:
+    const char* text;
+};
+
+// Conversions for as<T>(); the mutable ones need the document to create members later
+template <typename T, typename Enable = void>
+struct JsonConverter;
+
+class JsonVariantConst {
+public:
+    JsonVariantConst() : node(nullptr) {}
+    explicit JsonVariantConst(const host_json::Node* node) : node(node) {}
+
+    bool isNull() const {
+        return node == nullptr || node->type == host_json::Node::NUL;
+    }
+    size_t size() const {
+        return node != nullptr && (node->type == host_json::Node::ARRAY || node->type == host_json::Node::OBJECT)
+                   ? node->items.size()
+                   : 0;
+    }
+    bool containsKey(const char* key) const {
+        return node != nullptr && node->member(key) != nullptr;
+    }
+    bool containsKey(const String& key) const {
+        return containsKey(key.c_str());
+    }
+
+    JsonVariantConst operator[](const char* key) const {
+        return JsonVariantConst(node != nullptr ? node->member(key) : nullptr);
+    }
+    JsonVariantConst operator[](const String& key) const {
+        return (*this)[key.c_str()];
+    }
+    JsonVariantConst operator[](JsonString key) const {
+        return (*this)[key.c_str()];
+    }
+    JsonVariantConst operator[](int index) const {
+        return JsonVariantConst(node != nullptr && index >= 0 ? node->element(index) : nullptr);
+    }
+    JsonVariantConst operator[](size_t index) const {
+        return JsonVariantConst(node != nullptr ? node->element(index) : nullptr);
+    }
+
+    template <typename T>
+    T as() const {
+        return JsonConverter<T>::fromConst(node);
+    }
+    template <typename T>
+    bool is() const {
+        return JsonConverter<T>::matches(node);
+    }
+    template <typename T>
+    operator T() const {
+        return as<T>();
+    }
+
+    const char* operator|(const char* fallback) const {
+        return is<const char*>() ? node->text.c_str() : fallback;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value, T>::type operator|(T fallback) const {
+        return is<T>() ? as<T>() : fallback;
+    }
+
+    const host_json::Node* getNode() const {
+        return node;
+    }
+
+private:
+    const host_json::Node* node;
+};
+
+class JsonVariant {
+public:
+    JsonVariant() : doc(nullptr), node(nullptr), index(0) {}
+    JsonVariant(JsonDocument* doc, host_json::Node* node) : doc(doc), node(node), index(0) {}
+    JsonVariant(const JsonVariant& other) = default;
+
+    // Like ArduinoJson's member proxies: assigning a variant copies its value
+    JsonVariant& operator=(const JsonVariant& other) {
+        set(other.asConst());
+        return *this;
+    }
+    template <typename T>
+    JsonVariant& operator=(const T& value) {
+        set(value);
+        return *this;
+    }
+    JsonVariant& operator=(const char* value) {
+        set(value);
+        return *this;
+    }
+
+    operator JsonVariantConst() const {
+        return asConst();
+    }
+    JsonVariantConst asConst() const {
+        return JsonVariantConst(resolve());
+    }
+
+    bool isNull() const {
+        return asConst().isNull();
+    }
+    size_t size() const {
+        return asConst().size();
+    }
+    bool containsKey(const char* key) const {
+        return asConst().containsKey(key);
+    }
+
+    JsonVariant operator[](const char* key) const {
+        return member(key);
+    }
+    JsonVariant operator[](const String& key) const {
+        return member(key.c_str());
+    }
+    JsonVariant operator[](JsonString key) const {
+        return member(key.c_str());
+    }
+    JsonVariant operator[](int index) const {
+        return element(index < 0 ? 0 : (size_t)index);
+    }
+    JsonVariant operator[](size_t index) const {
+        return element(index);
+    }
+
+    template <typename T>
+    T as() const {
+        return JsonConverter<T>::from(doc, resolve());
+    }
+    template <typename T>
+    bool is() const {
+        return JsonConverter<T>::matches(resolve());
+    }
+    template <typename T>
+    operator T() const {
+        return as<T>();
+    }
+
+    const char* operator|(const char* fallback) const {
+        return asConst() | fallback;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value, T>::type operator|(T fallback) const {
+        return asConst() | fallback;
+    }
+
+    template <typename T>
+    T to() const;
+    JsonObject createNestedObject() const;
+    JsonObject createNestedObject(const char* key) const;
+    JsonObject createNestedObject(const String& key) const;
+    JsonObject createNestedObject(JsonString key) const;
+    JsonArray createNestedArray() const;
+    JsonArray createNestedArray(const char* key) const;
+    JsonArray createNestedArray(const String& key) const;
+    JsonArray createNestedArray(JsonString key) const;
+    template <typename T>
+    bool add(const T& value) const;
+
+    bool set(JsonVariantConst value) const;
+    bool set(const char* value) const;
+    bool set(const String& value) const {
+        return set(value.c_str());
+    }
+    bool set(const std::string& value) const {
+        return set(value.c_str());
+    }
+    bool set(JsonString value) const {
+        return set(value.c_str());
+    }
+    bool set(bool value) const;
+    bool set(std::nullptr_t) const;
+    bool set(const JsonVariant& value) const {
+        return set(value.asConst());
+    }
+    bool set(const JsonObject& value) const;
+    bool set(const JsonObjectConst& value) const;
+    bool set(const JsonArray& value) const;
+    bool set(const JsonArrayConst& value) const;
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, bool>::type set(T value) const;
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, bool>::type set(T value) const;
+
+    JsonDocument* getDocument() const {
+        return doc;
+    }
+    host_json::Node* resolve() const; // Existing node or nullptr, never creates
+    host_json::Node* materialize() const; // Creates the missing path on first write
+
+private:
+    JsonDocument* doc;
+    host_json::Node* node;
+    std::shared_ptr<JsonVariant> parent; // Set while the member or element does not exist yet
+    std::string key;
+    size_t index;
+
+    JsonVariant member(const char* name) const;
+    JsonVariant element(size_t position) const;
+};
+
+class JsonPair {
+public:
+    JsonPair(JsonString key, JsonVariant value) : pairKey(key), pairValue(value) {}
+    JsonString key() const {
+        return pairKey;
+    }
+    JsonVariant value() const {
+        return pairValue;
+    }
+
+private:
+    JsonString pairKey;
+    JsonVariant pairValue;
+};
+
+class JsonPairConst {
+public:
+    JsonPairConst(JsonString key, JsonVariantConst value) : pairKey(key), pairValue(value) {}
+    JsonString key() const {
+        return pairKey;
+    }
+    JsonVariantConst value() const {
+        return pairValue;
+    }
+
+private:
+    JsonString pairKey;
+    JsonVariantConst pairValue;
+};
+
+class JsonObjectConst {
+public:
+    class iterator {
+    public:
+        iterator(const host_json::Node* node, size_t position) : node(node), position(position) {}
+        JsonPairConst operator*() const {
+            return JsonPairConst(JsonString(node->keys[position].c_str()), JsonVariantConst(node->items[position]));
+        }
+        iterator& operator++() {
+            position++;
+            return *this;
+        }
+        bool operator!=(const iterator& other) const {
+            return position != other.position;
+        }
+
+    private:
+        const host_json::Node* node;
+        size_t position;
+    };
+
+    JsonObjectConst() : node(nullptr) {}
+    JsonObjectConst(JsonVariantConst variant)
+        : node(variant.getNode() != nullptr && variant.getNode()->type == host_json::Node::OBJECT ? variant.getNode() : nullptr) {}
+
+    bool isNull() const {
+        return node == nullptr;
+    }
+    size_t size() const {
+        return node != nullptr ? node->items.size() : 0;
+    }
+    bool containsKey(const char* key) const {
+        return node != nullptr && node->member(key) != nullptr;
+    }
+    JsonVariantConst operator[](const char* key) const {
+        return JsonVariantConst(node != nullptr ? node->member(key) : nullptr);
+    }
+    JsonVariantConst operator[](const String& key) const {
+        return (*this)[key.c_str()];
+    }
+    iterator begin() const {
+        return iterator(node, 0);
+    }
+    iterator end() const {
+        return iterator(node, size());
+    }
+    operator JsonVariantConst() const {
+        return JsonVariantConst(node);
+    }
+
+private:
+    const host_json::Node* node;
+};
+
+class JsonArrayConst {
+public:
+    class iterator {
+    public:
+        iterator(const host_json::Node* node, size_t position) : node(node), position(position) {}
+        JsonVariantConst operator*() const {
+            return JsonVariantConst(node->items[position]);
+        }
+        iterator& operator++() {
+            position++;
+            return *this;
+        }
+        bool operator!=(const iterator& other) const {
+            return position != other.position;
+        }
+
+    private:
+        const host_json::Node* node;
+        size_t position;
+    };
+
+    JsonArrayConst() : node(nullptr) {}
+    JsonArrayConst(JsonVariantConst variant)
+        : node(variant.getNode() != nullptr && variant.getNode()->type == host_json::Node::ARRAY ? variant.getNode() : nullptr) {}
+
+    bool isNull() const {
+        return node == nullptr;
+    }
+    size_t size() const {
+        return node != nullptr ? node->items.size() : 0;
+    }
+    JsonVariantConst operator[](size_t index) const {
+        return JsonVariantConst(node != nullptr ? node->element(index) : nullptr);
+    }
+    iterator begin() const {
+        return iterator(node, 0);
+    }
+    iterator end() const {
+        return iterator(node, size());
+    }
+    operator JsonVariantConst() const {
+        return JsonVariantConst(node);
+    }
+
+private:
+    const host_json::Node* node;
+};
+
+class JsonObject {
+public:
+    class iterator {
+    public:
+        iterator(JsonDocument* doc, host_json::Node* node, size_t position) : doc(doc), node(node), position(position) {}
+        JsonPair operator*() const {
+            return JsonPair(JsonString(node->keys[position].c_str()), JsonVariant(doc, node->items[position]));
+        }
+        iterator& operator++() {
+            position++;
+            return *this;
+        }
+        bool operator!=(const iterator& other) const {
+            return position != other.position;
+        }
+
+    private:
+        JsonDocument* doc;
+        host_json::Node* node;
+        size_t position;
+    };
+
+    JsonObject() {}
+    JsonObject(const JsonVariant& variant) : variant(variant) {}
+
+    bool isNull() const {
+        host_json::Node* node = variant.resolve();
+        return node == nullptr || node->type != host_json::Node::OBJECT;
+    }
+    size_t size() const {
+        return isNull() ? 0 : variant.resolve()->items.size();
+    }
+    bool containsKey(const char* key) const {
+        return variant.containsKey(key);
+    }
+    JsonVariant operator[](const char* key) const {
+        return variant[key];
+    }
+    JsonVariant operator[](const String& key) const {
+        return variant[key];
+    }
+    JsonVariant operator[](JsonString key) const {
+        return variant[key];
+    }
+    JsonObject createNestedObject(const char* key) const {
+        return variant.createNestedObject(key);
+    }
+    JsonObject createNestedObject(JsonString key) const {
+        return variant.createNestedObject(key);
+    }
+    JsonObject createNestedObject(const String& key) const {
+        return variant.createNestedObject(key);
+    }
+    JsonArray createNestedArray(const char* key) const;
+    JsonArray createNestedArray(JsonString key) const;
+    JsonArray createNestedArray(const String& key) const;
+    iterator begin() const {
+        return iterator(variant.getDocument(), isNull() ? nullptr : variant.resolve(), 0);
+    }
+    iterator end() const {
+        return iterator(variant.getDocument(), nullptr, size());
+    }
+    operator JsonVariantConst() const {
+        return variant.asConst();
+    }
+    operator JsonObjectConst() const {
+        return JsonObjectConst(variant.asConst());
+    }
+    JsonVariant getVariant() const {
+        return variant;
+    }
+
+private:
+    JsonVariant variant;
+};
+
+class JsonArray {
+public:
+    class iterator {
+    public:
+        iterator(JsonDocument* doc, host_json::Node* node, size_t position) : doc(doc), node(node), position(position) {}
+        JsonVariant operator*() const {
+            return JsonVariant(doc, node->items[position]);
+        }
+        iterator& operator++() {
+            position++;
+            return *this;
+        }
+        bool operator!=(const iterator& other) const {
+            return position != other.position;
+        }
+
+    private:
+        JsonDocument* doc;
+        host_json::Node* node;
+        size_t position;
+    };
+
+    JsonArray() {}
+    JsonArray(const JsonVariant& variant) : variant(variant) {}
+
+    bool isNull() const {
+        host_json::Node* node = variant.resolve();
+        return node == nullptr || node->type != host_json::Node::ARRAY;
+    }
+    size_t size() const {
+        return isNull() ? 0 : variant.resolve()->items.size();
+    }
+    JsonVariant operator[](size_t index) const {
+        return variant[index];
+    }
+    JsonVariant operator[](int index) const {
+        return variant[index];
+    }
+    JsonObject createNestedObject() const {
+        return variant.createNestedObject();
+    }
+    JsonArray createNestedArray() const {
+        return variant.createNestedArray();
+    }
+    template <typename T>
+    bool add(const T& value) const {
+        return variant.add(value);
+    }
+    iterator begin() const {
+        return iterator(variant.getDocument(), isNull() ? nullptr : variant.resolve(), 0);
+    }
+    iterator end() const {
+        return iterator(variant.getDocument(), nullptr, size());
+    }
+    operator JsonVariantConst() const {
+        return variant.asConst();
+    }
+    operator JsonArrayConst() const {
+        return JsonArrayConst(variant.asConst());
+    }
+    JsonVariant getVariant() const {
+        return variant;
+    }
+
+private:
+    JsonVariant variant;
+};
+
+inline JsonArray JsonObject::createNestedArray(const char* key) const {
+    return variant.createNestedArray(key);
+}
+
+inline JsonArray JsonObject::createNestedArray(JsonString key) const {
+    return variant.createNestedArray(key);
+}
+
+inline JsonArray JsonObject::createNestedArray(const String& key) const {
+    return variant.createNestedArray(key);
+}
+
+class JsonDocument {
+public:
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+    virtual ~JsonDocument() {}
+
+    size_t capacity() const {
+        return poolCapacity;
+    }
+    size_t memoryUsage() const {
+        return used;
+    }
+    bool overflowed() const {
+        return overflow;
+    }
+    void clear() {
+        nodes.clear();
+        root.reset();
+        used = 0;
+        overflow = false;
+    }
+
+    bool isNull() const {
+        return root.type == host_json::Node::NUL;
+    }
+    size_t size() const {
+        return getVariant().size();
+    }
+    bool containsKey(const char* key) const {
+        return root.member(key) != nullptr;
+    }
+
+    JsonVariant operator[](const char* key) {
+        return getVariant()[key];
+    }
+    JsonVariant operator[](const String& key) {
+        return getVariant()[key];
+    }
+    JsonVariant operator[](size_t index) {
+        return getVariant()[index];
+    }
+    JsonVariant operator[](int index) {
+        return getVariant()[index];
+    }
+    JsonVariantConst operator[](const char* key) const {
+        return JsonVariantConst(root.member(key));
+    }
+
+    template <typename T>
+    T as() {
+        return getVariant().as<T>();
+    }
+    template <typename T>
+    T as() const {
+        return JsonVariantConst(&root).as<T>();
+    }
+    template <typename T>
+    T to() {
+        clear();
+        return getVariant().to<T>();
+    }
+
+    JsonObject createNestedObject(const char* key) {
+        return getVariant().createNestedObject(key);
+    }
+    JsonArray createNestedArray(const char* key) {
+        return getVariant().createNestedArray(key);
+    }
+    template <typename T>
+    bool set(const T& value) {
+        clear(); // Like to<JsonVariant>(), the old content is released first
+        return getVariant().set(value);
+    }
+
+    JsonVariant getVariant() {
+        return JsonVariant(this, &root);
+    }
+    JsonVariantConst getVariant() const {
+        return JsonVariantConst(&root);
+    }
+    operator JsonVariantConst() const {
+        return getVariant();
+    }
+
+    // Storage hooks for variants and the parsers
+    host_json::Node* newNode() {
+        if (!reserve(HOST_JSON_SLOT_SIZE)) {
+            return nullptr;
+        }
+        nodes.push_back(host_json::Node());
+        return &nodes.back();
+    }
+    bool reserve(size_t bytes) {
+        if (overflow || used + bytes > poolCapacity) {
+            overflow = true;
+            return false;
+        }
+        used += bytes;
+        return true;
+    }
+    bool storeString(std::string& target, const char* text, size_t length) {
+        if (!reserve(length + 1)) {
+            return false;
+        }
+        target.assign(text, length);
+        return true;
+    }
+
+protected:
+    explicit JsonDocument(size_t capacity) : poolCapacity(capacity), used(0), overflow(false) {}
+
+private:
+    size_t poolCapacity;
+    size_t used;
+    bool overflow;
+    host_json::Node root;
+    std::deque<host_json::Node> nodes; // Host bookkeeping, the accounted size is what counts
+};
+
+// The pool is requested from the allocator so heap figures match the device, the nodes
+// themselves are kept in host containers
+template <typename TAllocator>
+class BasicJsonDocument : public JsonDocument {
+public:
+    explicit BasicJsonDocument(size_t capacity, TAllocator alloc = TAllocator())
+        : JsonDocument(capacity), allocator(alloc), pool(allocator.allocate(capacity)) {}
+    ~BasicJsonDocument() {
+        if (pool != nullptr) {
+            allocator.deallocate(pool);
+        }
+    }
+
+private:
+    TAllocator allocator;
+    void* pool;
+};
+
+struct DefaultAllocator {
+    void* allocate(size_t size) {
+        return malloc(size);
+    }
+    void deallocate(void* ptr) {
+        free(ptr);
+    }
+    void* reallocate(void* ptr, size_t newSize) {
+        return realloc(ptr, newSize);
+    }
+};
+
+typedef BasicJsonDocument<DefaultAllocator> DynamicJsonDocument;
+
+template <size_t Capacity>
+class StaticJsonDocument : public JsonDocument {
+public:
+    StaticJsonDocument() : JsonDocument(Capacity) {}
+};
+
+namespace host_json {
+
+inline bool copyInto(JsonDocument& doc, Node* target, const Node* source) {
+    target->reset();
+    if (source == nullptr) {
+        return true;
+    }
+    target->type = source->type;
+    target->boolean = source->boolean;
+    target->integer = source->integer;
+    target->real = source->real;
+    if (source->type == Node::STRING && !doc.storeString(target->text, source->text.data(), source->text.size())) {
+        target->reset();
+        return false;
+    }
+    for (size_t i = 0; i < source->items.size(); ++i) {
+        Node* item = doc.newNode();
+        if (item == nullptr) {
+            return false;
+        }
+        if (source->type == Node::OBJECT) {
+            std::string key;
+            if (!doc.storeString(key, source->keys[i].data(), source->keys[i].size())) {
+                return false;
+            }
+            target->keys.push_back(key);
+        }
+        target->items.push_back(item);
+        if (!copyInto(doc, item, source->items[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+inline host_json::Node* JsonVariant::resolve() const {
+    if (node != nullptr) {
+        return node;
+    }
+    if (!parent) {
+        return nullptr;
+    }
+    const host_json::Node* container = parent->resolve();
+    if (container == nullptr) {
+        return nullptr;
+    }
+    return const_cast<host_json::Node*>(key.empty() && container->type == host_json::Node::ARRAY ? container->element(index)
+                                                                                               : container->member(key.c_str()));
+}
+
+inline host_json::Node* JsonVariant::materialize() const {
+    host_json::Node* existing = resolve();
+    if (existing != nullptr || !parent || doc == nullptr) {
+        return existing;
+    }
+
+    host_json::Node* container = parent->materialize();
+    if (container == nullptr) {
+        return nullptr;
+    }
+    bool isMember = !key.empty() || index == (size_t)-1;
+    if (container->type == host_json::Node::NUL) {
+        container->type = isMember ? host_json::Node::OBJECT : host_json::Node::ARRAY;
+    }
+
+    if (isMember) {
+        if (container->type != host_json::Node::OBJECT) {
+            return nullptr;
+        }
+        host_json::Node* created = doc->newNode();
+        std::string name;
+        if (created == nullptr || !doc->storeString(name, key.data(), key.size())) {
+            return nullptr;
+        }
+        container->keys.push_back(name);
+        container->items.push_back(created);
+        return created;
+    }
+
+    // Elements up to the index are added as null, as ArduinoJson does
+    if (container->type != host_json::Node::ARRAY) {
+        return nullptr;
+    }
+    while (container->items.size() <= index) {
+        host_json::Node* created = doc->newNode();
+        if (created == nullptr) {
+            return nullptr;
+        }
+        container->items.push_back(created);
+    }
+    return container->items[index];
+}
+
+inline JsonVariant JsonVariant::member(const char* name) const {
+    JsonVariant result(doc, nullptr);
+    const host_json::Node* current = resolve();
+    if (current != nullptr && current->type == host_json::Node::OBJECT) {
+        result.node = const_cast<host_json::Node*>(current->member(name));
+        if (result.node != nullptr) {
+            return result;
+        }
+    }
+    result.parent = std::make_shared<JsonVariant>(*this);
+    result.key = name != nullptr ? name : "";
+    result.index = (size_t)-1; // Marks a member even when the key is empty
+    return result;
+}
+
+inline JsonVariant JsonVariant::element(size_t position) const {
+    JsonVariant result(doc, nullptr);
+    const host_json::Node* current = resolve();
+    if (current != nullptr && current->type == host_json::Node::ARRAY && position < current->items.size()) {
+        result.node = current->items[position];
+        return result;
+    }
+    result.parent = std::make_shared<JsonVariant>(*this);
+    result.index = position;
+    return result;
+}
+
+inline bool JsonVariant::set(JsonVariantConst value) const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return false;
+    }
+    if (target == value.getNode()) {
+        return true;
+    }
+    // The source may live inside the target, copy it out first
+    host_json::Node copy = value.getNode() != nullptr ? *value.getNode() : host_json::Node();
+    return host_json::copyInto(*doc, target, &copy);
+}
+
+inline bool JsonVariant::set(const char* value) const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return false;
+    }
+    target->reset();
+    if (value == nullptr) {
+        return true;
+    }
+    if (!doc->storeString(target->text, value, strlen(value))) {
+        return false;
+    }
+    target->type = host_json::Node::STRING;
+    return true;
+}
+
+inline bool JsonVariant::set(bool value) const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return false;
+    }
+    target->reset();
+    target->type = host_json::Node::BOOLEAN;
+    target->boolean = value;
+    return true;
+}
+
+inline bool JsonVariant::set(std::nullptr_t) const {
+    host_json::Node* target = materialize();
+    if (target != nullptr) {
+        target->reset();
+    }
+    return target != nullptr;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, bool>::type
+JsonVariant::set(T value) const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return false;
+    }
+    target->reset();
+    target->type = host_json::Node::INTEGER;
+    target->integer = (int64_t)value;
+    return true;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type JsonVariant::set(T value) const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return false;
+    }
+    target->reset();
+    target->type = host_json::Node::REAL;
+    target->real = value;
+    return true;
+}
+
+inline bool JsonVariant::set(const JsonObject& value) const {
+    return set((JsonVariantConst)value);
+}
+
+inline bool JsonVariant::set(const JsonObjectConst& value) const {
+    return set((JsonVariantConst)value);
+}
+
+inline bool JsonVariant::set(const JsonArray& value) const {
+    return set((JsonVariantConst)value);
+}
+
+inline bool JsonVariant::set(const JsonArrayConst& value) const {
+    return set((JsonVariantConst)value);
+}
+
+template <typename T>
+inline bool JsonVariant::add(const T& value) const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return false;
+    }
+    if (target->type == host_json::Node::NUL) {
+        target->type = host_json::Node::ARRAY;
+    }
+    if (target->type != host_json::Node::ARRAY) {
+        return false;
+    }
+    return JsonVariant(doc, target)[target->items.size()].set(value);
+}
+
+template <>
+inline JsonObject JsonVariant::to<JsonObject>() const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return JsonObject();
+    }
+    target->reset();
+    target->type = host_json::Node::OBJECT;
+    return JsonObject(JsonVariant(doc, target));
+}
+
+template <>
+inline JsonArray JsonVariant::to<JsonArray>() const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return JsonArray();
+    }
+    target->reset();
+    target->type = host_json::Node::ARRAY;
+    return JsonArray(JsonVariant(doc, target));
+}
+
+inline JsonObject JsonVariant::createNestedObject() const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return JsonObject();
+    }
+    if (target->type == host_json::Node::NUL) {
+        target->type = host_json::Node::ARRAY;
+    }
+    if (target->type != host_json::Node::ARRAY) {
+        return JsonObject();
+    }
+    return JsonVariant(doc, target)[target->items.size()].to<JsonObject>();
+}
+
+inline JsonObject JsonVariant::createNestedObject(const char* key) const {
+    return (*this)[key].to<JsonObject>();
+}
+
+inline JsonObject JsonVariant::createNestedObject(const String& key) const {
+    return (*this)[key].to<JsonObject>();
+}
+
+inline JsonObject JsonVariant::createNestedObject(JsonString key) const {
+    return (*this)[key].to<JsonObject>();
+}
+
+inline JsonArray JsonVariant::createNestedArray() const {
+    host_json::Node* target = materialize();
+    if (target == nullptr) {
+        return JsonArray();
+    }
+    if (target->type == host_json::Node::NUL) {
+        target->type = host_json::Node::ARRAY;
+    }
+    if (target->type != host_json::Node::ARRAY) {
+        return JsonArray();
+    }
+    return JsonVariant(doc, target)[target->items.size()].to<JsonArray>();
+}
+
+inline JsonArray JsonVariant::createNestedArray(const char* key) const {
+    return (*this)[key].to<JsonArray>();
+}
+
+inline JsonArray JsonVariant::createNestedArray(const String& key) const {
+    return (*this)[key].to<JsonArray>();
+}
+
+inline JsonArray JsonVariant::createNestedArray(JsonString key) const {
+    return (*this)[key].to<JsonArray>();
+}
+
+// Converters
+
+template <typename T>
+struct JsonConverter<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    static T fromConst(const host_json::Node* node) {
+        if (node == nullptr) {
+            return 0;
+        }
+        if (node->type == host_json::Node::INTEGER) {
+            return (T)node->integer;
+        }
+        if (node->type == host_json::Node::REAL) {
+            return (T)(int64_t)node->real;
+        }
+        if (node->type == host_json::Node::BOOLEAN) {
+            return node->boolean ? 1 : 0;
+        }
+        return 0;
+    }
+    static T from(JsonDocument*, const host_json::Node* node) {
+        return fromConst(node);
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::INTEGER;
+    }
+};
+
+template <typename T>
+struct JsonConverter<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static T fromConst(const host_json::Node* node) {
+        return node != nullptr ? (T)node->number() : 0;
+    }
+    static T from(JsonDocument*, const host_json::Node* node) {
+        return fromConst(node);
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->isNumber();
+    }
+};
+
+template <>
+struct JsonConverter<bool> {
+    static bool fromConst(const host_json::Node* node) {
+        if (node == nullptr) {
+            return false;
+        }
+        if (node->type == host_json::Node::BOOLEAN) {
+            return node->boolean;
+        }
+        return node->isNumber() && node->number() != 0;
+    }
+    static bool from(JsonDocument*, const host_json::Node* node) {
+        return fromConst(node);
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::BOOLEAN;
+    }
+};
+
+template <>
+struct JsonConverter<const char*> {
+    static const char* fromConst(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::STRING ? node->text.c_str() : nullptr;
+    }
+    static const char* from(JsonDocument*, const host_json::Node* node) {
+        return fromConst(node);
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::STRING;
+    }
+};
+
+// Non-string values come back in their JSON form, "null" included, as in ArduinoJson 6.18+
+template <>
+struct JsonConverter<String> {
+    static String fromConst(const host_json::Node* node) {
+        if (node != nullptr && node->type == host_json::Node::STRING) {
+            return String(node->text.c_str());
+        }
+        host_json::StringWriter writer;
+        host_json::writeJson(writer, node);
+        return String(writer.text.c_str());
+    }
+    static String from(JsonDocument*, const host_json::Node* node) {
+        return fromConst(node);
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::STRING;
+    }
+};
+
+template <>
+struct JsonConverter<JsonVariantConst> {
+    static JsonVariantConst fromConst(const host_json::Node* node) {
+        return JsonVariantConst(node);
+    }
+    static JsonVariantConst from(JsonDocument*, const host_json::Node* node) {
+        return fromConst(node);
+    }
+    static bool matches(const host_json::Node*) {
+        return true;
+    }
+};
+
+template <>
+struct JsonConverter<JsonObjectConst> {
+    static JsonObjectConst fromConst(const host_json::Node* node) {
+        return JsonObjectConst(JsonVariantConst(node));
+    }
+    static JsonObjectConst from(JsonDocument*, const host_json::Node* node) {
+        return fromConst(node);
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::OBJECT;
+    }
+};
+
+template <>
+struct JsonConverter<JsonArrayConst> {
+    static JsonArrayConst fromConst(const host_json::Node* node) {
+        return JsonArrayConst(JsonVariantConst(node));
+    }
+    static JsonArrayConst from(JsonDocument*, const host_json::Node* node) {
+        return fromConst(node);
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::ARRAY;
+    }
+};
+
+template <>
+struct JsonConverter<JsonVariant> {
+    static JsonVariant from(JsonDocument* doc, const host_json::Node* node) {
+        return JsonVariant(doc, const_cast<host_json::Node*>(node));
+    }
+    static bool matches(const host_json::Node*) {
+        return true;
+    }
+};
+
+template <>
+struct JsonConverter<JsonObject> {
+    static JsonObject from(JsonDocument* doc, const host_json::Node* node) {
+        bool isObject = node != nullptr && node->type == host_json::Node::OBJECT;
+        return JsonObject(JsonVariant(doc, isObject ? const_cast<host_json::Node*>(node) : nullptr));
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::OBJECT;
+    }
+};
+
+template <>
+struct JsonConverter<JsonArray> {
+    static JsonArray from(JsonDocument* doc, const host_json::Node* node) {
+        bool isArray = node != nullptr && node->type == host_json::Node::ARRAY;
+        return JsonArray(JsonVariant(doc, isArray ? const_cast<host_json::Node*>(node) : nullptr));
+    }
+    static bool matches(const host_json::Node* node) {
+        return node != nullptr && node->type == host_json::Node::ARRAY;
+    }
+};
+
+// Parsers
+
+namespace host_json {
+
+class Parser {
+public:
+    Parser(JsonDocument& doc, const uint8_t* input, size_t length) : doc(doc), input(input), length(length), position(0) {}
+
+    DeserializationError parseJson(Node* target) {
+        skipSpace();
+        if (position == length) {
+            return DeserializationError::EmptyInput;
+        }
+        return parseJsonValue(target, 0);
+    }
+
+    DeserializationError parseMsgPack(Node* target) {
+        if (length == 0) {
+            return DeserializationError::EmptyInput;
+        }
+        return parseMsgPackValue(target, 0);
+    }
+
+private:
+    JsonDocument& doc;
+    const uint8_t* input;
+    size_t length;
+    size_t position;
+
+    void skipSpace() {
+        while (position < length && (input[position] == ' ' || input[position] == '\t' || input[position] == '\n' ||
+                                     input[position] == '\r')) {
+            position++;
+        }
+    }
+
+    DeserializationError error() const {
+        return position >= length ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+    }
+
+    bool literal(const char* word) {
+        size_t wordLength = strlen(word);
+        if (position + wordLength > length || memcmp(input + position, word, wordLength) != 0) {
+            return false;
+        }
+        position += wordLength;
+        return true;
+    }
+
+    DeserializationError parseJsonValue(Node* target, int depth) {
+        skipSpace();
+        if (position >= length) {
+            return DeserializationError::IncompleteInput;
+        }
+        char c = (char)input[position];
+        if (c == '{' || c == '[') {
+            if (depth >= HOST_JSON_NESTING_LIMIT) {
+                return DeserializationError::TooDeep;
+            }
+            return c == '{' ? parseJsonObject(target, depth + 1) : parseJsonArray(target, depth + 1);
+        }
+        if (c == '"' || c == '\'') {
+            std::string text;
+            DeserializationError result = parseJsonString(text);
+            if (result) {
+                return result;
+            }
+            if (!doc.storeString(target->text, text.data(), text.size())) {
+                return DeserializationError::NoMemory;
+            }
+            target->type = Node::STRING;
+            return DeserializationError::Ok;
+        }
+        if (literal("true")) {
+            target->type = Node::BOOLEAN;
+            target->boolean = true;
+            return DeserializationError::Ok;
+        }
+        if (literal("false")) {
+            target->type = Node::BOOLEAN;
+            target->boolean = false;
+            return DeserializationError::Ok;
+        }
+        if (literal("null")) {
+            return DeserializationError::Ok;
+        }
+        return parseJsonNumber(target);
+    }
+
+    DeserializationError parseJsonNumber(Node* target) {
+        size_t start = position;
+        bool real = false;
+        while (position < length) {
+            char c = (char)input[position];
+            if (c == '.' || c == 'e' || c == 'E') {
+                real = true;
+            } else if (!(isdigit((unsigned char)c) || c == '-' || c == '+')) {
+                break;
+            }
+            position++;
+        }
+        if (position == start) {
+            return error();
+        }
+
+        std::string text((const char*)input + start, position - start);
+        char* end = nullptr;
+        if (!real) {
+            errno = 0;
+            long long value = strtoll(text.c_str(), &end, 10);
+            if (*end == '\0' && errno == 0) {
+                target->type = Node::INTEGER;
+                target->integer = value;
+                return DeserializationError::Ok;
+            }
+        }
+        double value = strtod(text.c_str(), &end);
+        if (*end != '\0') {
+            return DeserializationError::InvalidInput;
+        }
+        target->type = Node::REAL;
+        target->real = value;
+        return DeserializationError::Ok;
+    }
+
+    static void appendUtf8(std::string& text, uint32_t codepoint) {
+        if (codepoint < 0x80) {
+            text += (char)codepoint;
+        } else if (codepoint < 0x800) {
+            text += (char)(0xC0 | (codepoint >> 6));
+            text += (char)(0x80 | (codepoint & 0x3F));
+        } else if (codepoint < 0x10000) {
+            text += (char)(0xE0 | (codepoint >> 12));
+            text += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            text += (char)(0x80 | (codepoint & 0x3F));
+        } else {
+            text += (char)(0xF0 | (codepoint >> 18));
+            text += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+            text += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            text += (char)(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    bool parseHex4(uint32_t& value) {
+        if (position + 4 > length) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = (char)input[position++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                value |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                value |= c - 'A' + 10;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    DeserializationError parseJsonString(std::string& text) {
+        char quote = (char)input[position++];
+        while (position < length) {
+            char c = (char)input[position++];
+            if (c == quote) {
+                return DeserializationError::Ok;
+            }
+            if (c != '\\') {
+                text += c;
+                continue;
+            }
+            if (position >= length) {
+                break;
+            }
+            char escaped = (char)input[position++];
+            switch (escaped) {
+                case '"': text += '"'; break;
+                case '\'': text += '\''; break;
+                case '\\': text += '\\'; break;
+                case '/': text += '/'; break;
+                case 'b': text += '\b'; break;
+                case 'f': text += '\f'; break;
+                case 'n': text += '\n'; break;
+                case 'r': text += '\r'; break;
+                case 't': text += '\t'; break;
+                case 'u': {
+                    uint32_t codepoint;
+                    if (!parseHex4(codepoint)) {
+                        return error();
+                    }
+                    // Surrogate pairs combine into one code point
+                    if (codepoint >= 0xD800 && codepoint < 0xDC00 && position + 6 <= length && input[position] == '\\' &&
+                        input[position + 1] == 'u') {
+                        position += 2;
+                        uint32_t low;
+                        if (!parseHex4(low)) {
+                            return error();
+                        }
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(text, codepoint);
+                    break;
+                }
+                default:
+                    return DeserializationError::InvalidInput;
+            }
+        }
+        return DeserializationError::IncompleteInput;
+    }
+
+    DeserializationError parseJsonObject(Node* target, int depth) {
+        position++; // '{'
+        target->type = Node::OBJECT;
+        skipSpace();
+        if (position < length && input[position] == '}') {
+            position++;
+            return DeserializationError::Ok;
+        }
+        while (true) {
+            skipSpace();
+            if (position >= length) {
+                return DeserializationError::IncompleteInput;
+            }
+            if (input[position] != '"' && input[position] != '\'') {
+                return DeserializationError::InvalidInput;
+            }
+            std::string key;
+            DeserializationError result = parseJsonString(key);
+            if (result) {
+                return result;
+            }
+            skipSpace();
+            if (position >= length) {
+                return DeserializationError::IncompleteInput;
+            }
+            if (input[position++] != ':') {
+                return DeserializationError::InvalidInput;
+            }
+
+            Node* value = doc.newNode();
+            std::string storedKey;
+            if (value == nullptr || !doc.storeString(storedKey, key.data(), key.size())) {
+                return DeserializationError::NoMemory;
+            }
+            result = parseJsonValue(value, depth);
+            if (result) {
+                return result;
+            }
+            target->keys.push_back(storedKey);
+            target->items.push_back(value);
+
+            skipSpace();
+            if (position >= length) {
+                return DeserializationError::IncompleteInput;
+            }
+            char c = (char)input[position++];
+            if (c == '}') {
+                return DeserializationError::Ok;
+            }
+            if (c != ',') {
+                return DeserializationError::InvalidInput;
+            }
+        }
+    }
+
+    DeserializationError parseJsonArray(Node* target, int depth) {
+        position++; // '['
+        target->type = Node::ARRAY;
+        skipSpace();
+        if (position < length && input[position] == ']') {
+            position++;
+            return DeserializationError::Ok;
+        }
+        while (true) {
+            Node* value = doc.newNode();
+            if (value == nullptr) {
+                return DeserializationError::NoMemory;
+            }
+            DeserializationError result = parseJsonValue(value, depth);
+            if (result) {
+                return result;
+            }
+            target->items.push_back(value);
+
+            skipSpace();
+            if (position >= length) {
+                return DeserializationError::IncompleteInput;
+            }
+            char c = (char)input[position++];
+            if (c == ']') {
+                return DeserializationError::Ok;
+            }
+            if (c != ',') {
+                return DeserializationError::InvalidInput;
+            }
+        }
+    }
+
+    bool readBigEndian(int bytes, uint64_t& value) {
+        if (position + bytes > length) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value = (value << 8) | input[position++];
+        }
+        return true;
+    }
+
+    DeserializationError readMsgPackString(size_t size, std::string& text) {
+        if (position + size > length) {
+            return DeserializationError::IncompleteInput;
+        }
+        text.assign((const char*)input + position, size);
+        position += size;
+        return DeserializationError::Ok;
+    }
+
+    DeserializationError parseMsgPackValue(Node* target, int depth) {
+        if (position >= length) {
+            return DeserializationError::IncompleteInput;
+        }
+        uint8_t marker = input[position++];
+        uint64_t value = 0;
+
+        if (marker <= 0x7F) {
+            target->type = Node::INTEGER;
+            target->integer = marker;
+            return DeserializationError::Ok;
+        }
+        if (marker >= 0xE0) {
+            target->type = Node::INTEGER;
+            target->integer = (int8_t)marker;
+            return DeserializationError::Ok;
+        }
+        if ((marker & 0xE0) == 0xA0 || marker == 0xD9 || marker == 0xDA || marker == 0xDB) {
+            size_t size = marker & 0x1F;
+            if (marker >= 0xD9 && !readBigEndian(1 << (marker - 0xD9), value)) {
+                return DeserializationError::IncompleteInput;
+            }
+            if (marker >= 0xD9) {
+                size = value;
+            }
+            std::string text;
+            DeserializationError result = readMsgPackString(size, text);
+            if (result) {
+                return result;
+            }
+            if (!doc.storeString(target->text, text.data(), text.size())) {
+                return DeserializationError::NoMemory;
+            }
+            target->type = Node::STRING;
+            return DeserializationError::Ok;
+        }
+        if ((marker & 0xF0) == 0x90 || marker == 0xDC || marker == 0xDD) {
+            size_t count = marker & 0x0F;
+            if (marker == 0xDC || marker == 0xDD) {
+                if (!readBigEndian(marker == 0xDC ? 2 : 4, value)) {
+                    return DeserializationError::IncompleteInput;
+                }
+                count = value;
+            }
+            if (depth >= HOST_JSON_NESTING_LIMIT) {
+                return DeserializationError::TooDeep;
+            }
+            target->type = Node::ARRAY;
+            for (size_t i = 0; i < count; ++i) {
+                Node* item = doc.newNode();
+                if (item == nullptr) {
+                    return DeserializationError::NoMemory;
+                }
+                DeserializationError result = parseMsgPackValue(item, depth + 1);
+                if (result) {
+                    return result;
+                }
+                target->items.push_back(item);
+            }
+            return DeserializationError::Ok;
+        }
+        if ((marker & 0xF0) == 0x80 || marker == 0xDE || marker == 0xDF) {
+            size_t count = marker & 0x0F;
+            if (marker == 0xDE || marker == 0xDF) {
+                if (!readBigEndian(marker == 0xDE ? 2 : 4, value)) {
+                    return DeserializationError::IncompleteInput;
+                }
+                count = value;
+            }
+            if (depth >= HOST_JSON_NESTING_LIMIT) {
+                return DeserializationError::TooDeep;
+            }
+            target->type = Node::OBJECT;
+            for (size_t i = 0; i < count; ++i) {
+                Node key;
+                DeserializationError result = parseMsgPackValue(&key, depth + 1);
+                if (result) {
+                    return result;
+                }
+                if (key.type != Node::STRING) {
+                    return DeserializationError::InvalidInput; // Only string keys are supported
+                }
+                Node* item = doc.newNode();
+                if (item == nullptr) {
+                    return DeserializationError::NoMemory;
+                }
+                result = parseMsgPackValue(item, depth + 1);
+                if (result) {
+                    return result;
+                }
+                target->keys.push_back(key.text);
+                target->items.push_back(item);
+            }
+            return DeserializationError::Ok;
+        }
+
+        switch (marker) {
+            case 0xC0:
+                return DeserializationError::Ok;
+            case 0xC2:
+            case 0xC3:
+                target->type = Node::BOOLEAN;
+                target->boolean = marker == 0xC3;
+                return DeserializationError::Ok;
+            case 0xCA: {
+                if (!readBigEndian(4, value)) {
+                    return DeserializationError::IncompleteInput;
+                }
+                uint32_t bits = (uint32_t)value;
+                float real;
+                memcpy(&real, &bits, sizeof(real));
+                target->type = Node::REAL;
+                target->real = real;
+                return DeserializationError::Ok;
+            }
+            case 0xCB: {
+                if (!readBigEndian(8, value)) {
+                    return DeserializationError::IncompleteInput;
+                }
+                memcpy(&target->real, &value, sizeof(target->real));
+                target->type = Node::REAL;
+                return DeserializationError::Ok;
+            }
+            case 0xCC:
+            case 0xCD:
+            case 0xCE:
+            case 0xCF:
+                if (!readBigEndian(1 << (marker - 0xCC), value)) {
+                    return DeserializationError::IncompleteInput;
+                }
+                target->type = Node::INTEGER;
+                target->integer = (int64_t)value;
+                return DeserializationError::Ok;
+            case 0xD0:
+            case 0xD1:
+            case 0xD2:
+            case 0xD3: {
+                int bytes = 1 << (marker - 0xD0);
+                if (!readBigEndian(bytes, value)) {
+                    return DeserializationError::IncompleteInput;
+                }
+                int shift = 64 - 8 * bytes; // Sign-extend
+                target->type = Node::INTEGER;
+                target->integer = (int64_t)(value << shift) >> shift;
+                return DeserializationError::Ok;
+            }
+            default:
+                return DeserializationError::InvalidInput; // bin, ext and timestamps are not used here
+        }
+    }
+};
+
+inline DeserializationError deserialize(JsonDocument& doc, const uint8_t* input, size_t length, bool msgPack) {
+    doc.clear();
+    if (input == nullptr) {
+        return DeserializationError::EmptyInput;
+    }
+    Parser parser(doc, input, length);
+    JsonVariant root = doc.getVariant();
+    DeserializationError result = msgPack ? parser.parseMsgPack(root.resolve()) : parser.parseJson(root.resolve());
+    if (result) {
+        doc.clear();
+    }
+    return result;
+}
+
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length) {
+    return host_json::deserialize(doc, (const uint8_t*)input, length, false);
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input) {
+    return deserializeJson(doc, input, input != nullptr ? strlen(input) : 0);
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const String& input) {
+    return deserializeJson(doc, input.c_str(), input.length());
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const std::string& input) {
+    return deserializeJson(doc, input.data(), input.size());
+}
+
+inline DeserializationError deserializeMsgPack(JsonDocument& doc, const uint8_t* input, size_t length) {
+    return host_json::deserialize(doc, input, length, true);
+}
+
+inline DeserializationError deserializeMsgPack(JsonDocument& doc, const char* input, size_t length) {
+    return deserializeMsgPack(doc, (const uint8_t*)input, length);
+}
+
+// Serializers accept anything that converts to a read-only variant
+
+inline JsonVariantConst hostJsonSource(JsonVariantConst source) {
+    return source;
+}
+
+inline JsonVariantConst hostJsonSource(const JsonDocument& source) {
+    return source.getVariant();
+}
+
+template <typename Source, typename Writer>
+size_t serializeJson(const Source& source, Writer& writer) {
+    host_json::BufferWriter counter = {nullptr, 0, 0, 0};
+    host_json::writeJson(counter, hostJsonSource(source).getNode());
+    host_json::writeJson(writer, hostJsonSource(source).getNode());
+    return counter.wanted;
+}
+
+template <typename Source>
+size_t serializeJson(const Source& source, String& output) {
+    host_json::StringWriter writer;
+    host_json::writeJson(writer, hostJsonSource(source).getNode());
+    output = String(writer.text.c_str());
+    return writer.text.size();
+}
+
+template <typename Source>
+size_t serializeJson(const Source& source, std::string& output) {
+    host_json::StringWriter writer;
+    host_json::writeJson(writer, hostJsonSource(source).getNode());
+    output = writer.text;
+    return writer.text.size();
+}
+
+template <typename Source>
+size_t serializeJson(const Source& source, char* buffer, size_t capacity) {
+    if (capacity == 0) {
+        return 0;
+    }
+    host_json::BufferWriter writer = {(uint8_t*)buffer, capacity - 1, 0, 0};
+    host_json::writeJson(writer, hostJsonSource(source).getNode());
+    buffer[writer.length] = '\0';
+    return writer.length;
+}
+
+template <typename Source>
+size_t measureJson(const Source& source) {
+    host_json::BufferWriter counter = {nullptr, 0, 0, 0};
+    host_json::writeJson(counter, hostJsonSource(source).getNode());
+    return counter.wanted;
+}
+
+template <typename Source>
+size_t serializeMsgPack(const Source& source, uint8_t* buffer, size_t capacity) {
+    host_json::BufferWriter writer = {buffer, capacity, 0, 0};
+    host_json::writeMsgPack(writer, hostJsonSource(source).getNode());
+    return writer.length;
+}
+
+template <typename Source>
+size_t serializeMsgPack(const Source& source, char* buffer, size_t capacity) {
+    return serializeMsgPack(source, (uint8_t*)buffer, capacity);
+}
+
+template <typename Source>
+size_t measureMsgPack(const Source& source) {
+    host_json::BufferWriter counter = {nullptr, 0, 0, 0};
+    host_json::writeMsgPack(counter, hostJsonSource(source).getNode());
+    return counter.wanted;
+}
+
+#endif // HOST_ARDUINO_JSON_H
@@ -0,0 +1,65 @@
+#include "esp_heap_caps.h"
+#include <atomic>
+#include <stdlib.h>
+
+namespace {
+
+std::atomic<size_t> bytesInUse(0);
+
+// Each allocation carries its size in front so frees can be counted
+struct Prefix {
+    size_t size;
+    size_t padding; // Keeps the payload 16-byte aligned
+};
+
+}
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    Prefix* prefix = (Prefix*)malloc(sizeof(Prefix) + size);
+    if (prefix == nullptr) {
+        return nullptr;
+    }
+    prefix->size = size;
+    bytesInUse += size;
+    return prefix + 1;
+}
+
+void* heap_caps_realloc(void* ptr, size_t size, uint32_t caps) {
+    if (ptr == nullptr) {
+        return heap_caps_malloc(size, caps);
+    }
+    Prefix* prefix = (Prefix*)ptr - 1;
+    size_t oldSize = prefix->size;
+    prefix = (Prefix*)realloc(prefix, sizeof(Prefix) + size);
+    if (prefix == nullptr) {
+        return nullptr;
+    }
+    prefix->size = size;
+    bytesInUse += size;
+    bytesInUse -= oldSize;
+    return prefix + 1;
+}
+
+void heap_caps_free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    Prefix* prefix = (Prefix*)ptr - 1;
+    bytesInUse -= prefix->size;
+    free(prefix);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    (void)caps;
+    return 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    (void)caps;
+    return 0;
+}
+
+size_t host_heap_bytes_in_use() {
+    return bytesInUse;
+}
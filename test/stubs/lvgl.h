@@ -0,0 +1,97 @@
+// Host stand-in for LVGL 8 with LV_COLOR_DEPTH 16, only the types the tested sources use
+#ifndef HOST_LVGL_H
+#define HOST_LVGL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int16_t lv_coord_t;
+
+typedef union {
+    struct {
+        uint16_t blue : 5;
+        uint16_t green : 6;
+        uint16_t red : 5;
+    } ch;
+    uint16_t full;
+} lv_color16_t;
+
+typedef lv_color16_t lv_color_t;
+typedef uint8_t lv_opa_t;
+
+#define LV_OPA_20 51
+#define LV_OPA_COVER 255
+
+typedef struct {
+    lv_coord_t x1;
+    lv_coord_t y1;
+    lv_coord_t x2;
+    lv_coord_t y2;
+} lv_area_t;
+
+// Styles only record what was set, nothing is drawn
+typedef struct {
+    lv_color_t textColor;
+    lv_color_t arcColor;
+    lv_opa_t textOpa;
+    lv_opa_t arcOpa;
+} lv_style_t;
+
+typedef struct _lv_timer_t lv_timer_t;
+typedef void (*lv_timer_cb_t)(lv_timer_t*);
+
+struct _lv_timer_t {
+    lv_timer_cb_t timer_cb;
+    uint32_t period;
+    void* user_data;
+};
+
+inline lv_color_t lv_color_hex(uint32_t c) {
+    lv_color_t color;
+    color.ch.red = (c >> 19) & 0x1F;
+    color.ch.green = (c >> 10) & 0x3F;
+    color.ch.blue = (c >> 3) & 0x1F;
+    return color;
+}
+
+inline void lv_style_reset(lv_style_t* style) {
+    style->textColor.full = 0;
+    style->arcColor.full = 0;
+    style->textOpa = LV_OPA_COVER;
+    style->arcOpa = LV_OPA_COVER;
+}
+
+inline void lv_style_init(lv_style_t* style) {
+    lv_style_reset(style);
+}
+
+inline void lv_style_set_text_color(lv_style_t* style, lv_color_t color) {
+    style->textColor = color;
+}
+
+inline void lv_style_set_arc_color(lv_style_t* style, lv_color_t color) {
+    style->arcColor = color;
+}
+
+inline void lv_style_set_text_opa(lv_style_t* style, lv_opa_t opa) {
+    style->textOpa = opa;
+}
+
+inline void lv_style_set_arc_opa(lv_style_t* style, lv_opa_t opa) {
+    style->arcOpa = opa;
+}
+
+inline void lv_obj_report_style_change(lv_style_t* style) {
+    (void)style;
+}
+
+// Timers never fire on the host, tests call the callback themselves
+inline lv_timer_t* lv_timer_create(lv_timer_cb_t callback, uint32_t period, void* userData) {
+    return new lv_timer_t{callback, period, userData};
+}
+
+inline void lv_timer_del(lv_timer_t* timer) {
+    delete timer;
+}
+
+#endif // HOST_LVGL_H
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""Replay a capture downloaded from the panel's /capture endpoint.
+
+Each captured request is re-sent to /data at 1x, Nx or maximum speed. With --senders N the
+capture is replayed by N concurrent connections, each posting under its own source id.
+The script reports throughput, the per-request latency distribution and the panel's memory
+figures from /stats before and after the run.
+
+With --local the capture is replayed through the host build of the ingest path instead
+(test/ReplayCapture: frame assembly, parsing and SensorModel, no widgets), as fast as it runs.
+
+    curl -X POST "http://<panel>/capture/start?size=2097152"
+    curl -o prod.jrcap "http://<panel>/capture"
+    python3 tools/replay_capture.py prod.jrcap --host <panel> --speed 4
+    python3 tools/replay_capture.py prod.jrcap --local _gate_build/ReplayCapture --loops 10
+"""
+
+import argparse
+import http.client
+import json
+import struct
+import subprocess
+import sys
+import threading
+import time
+
+MAGIC = b"JRCAP1\0\0"
+RECORD_HEADER = struct.Struct("<IHHI")
+FLAG_REQUEST_START = 0x0001
+
+
+def load_requests(path):
+    """Returns [(timestamp_ms, [chunk, ...]), ...] in arrival order."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if not data.startswith(MAGIC):
+        sys.exit(f"{path}: not a capture file")
+
+    requests = []
+    offset = len(MAGIC)
+    while offset + RECORD_HEADER.size <= len(data):
+        timestamp, flags, _, length = RECORD_HEADER.unpack_from(data, offset)
+        offset += RECORD_HEADER.size
+        chunk = data[offset:offset + length]
+        offset += length
+        if flags & FLAG_REQUEST_START or not requests:
+            # The ring may start mid-request when old records were dropped; that partial
+            # request is kept as a request of its own, as the panel would have seen it
+            requests.append((timestamp, []))
+        requests[-1][1].append(chunk)
+    return requests
+
+
+def fetch_stats(host, port):
+    try:
+        conn = http.client.HTTPConnection(host, port, timeout=5)
+        conn.request("GET", "/stats")
+        stats = json.loads(conn.getresponse().read())
+        conn.close()
+        return stats
+    except (OSError, ValueError):
+        return None
+
+
+def post_request(conn, chunks, source=None):
+    body = b"".join(chunks)
+    path = "/data" if source is None else f"/data?source={source}"
+    start = time.perf_counter()
+    conn.request("POST", path, body=body, headers={"Content-Type": "application/octet-stream"})
+    conn.getresponse().read()
+    return time.perf_counter() - start, len(body)
+
+
+def replay(args, requests, source):
+    conn = http.client.HTTPConnection(args.host, args.port, timeout=10)
+    latencies = []
+    total_bytes = 0
+    failures = 0
+
+    for _ in range(args.loops):
+        base_ms = requests[0][0]
+        loop_start = time.perf_counter()
+        for timestamp, chunks in requests:
+            if args.speed > 0:
+                due = loop_start + (timestamp - base_ms) / 1000.0 / args.speed
+                delay = due - time.perf_counter()
+                if delay > 0:
+                    time.sleep(delay)
+            try:
+                latency, size = post_request(conn, chunks, source)
+                latencies.append(latency)
+                total_bytes += size
+            except (OSError, http.client.HTTPException):
+                failures += 1
+                conn.close()
+                conn = http.client.HTTPConnection(args.host, args.port, timeout=10)
+
+    conn.close()
+    return latencies, total_bytes, failures
+
+
+def percentile(sorted_values, fraction):
+    index = min(len(sorted_values) - 1, int(fraction * len(sorted_values)))
+    return sorted_values[index]
+
+
+def replay_local(args):
+    # The host replay prints its own report, the per-frame Serial logging is dropped
+    command = [args.local, args.capture, "--loops", str(args.loops), "--senders", str(args.senders)]
+    result = subprocess.run(command, stderr=subprocess.PIPE, text=True)
+    errors = [line for line in result.stderr.splitlines() if not line.startswith("Length Prefix Detected")]
+    if errors:
+        print("\n".join(errors), file=sys.stderr)
+    sys.exit(result.returncode)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture")
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument("--host", help="panel to post the capture to")
+    target.add_argument("--local", metavar="REPLAY_BINARY", help="replay through the host build instead, e.g. _gate_build/ReplayCapture")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--speed", type=float, default=1.0, help="time scale, 0 replays as fast as possible")
+    parser.add_argument("--loops", type=int, default=1)
+    parser.add_argument("--senders", type=int, default=1, help="concurrent simulated hosts, each with its own source id")
+    args = parser.parse_args()
+
+    if args.local:
+        replay_local(args)
+
+    requests = load_requests(args.capture)
+    if not requests:
+        sys.exit("capture contains no requests")
+
+    before = fetch_stats(args.host, args.port)
+    results = []
+    run_start = time.perf_counter()
+    if args.senders > 1:
+        # Each simulated host replays the whole capture on its own connection under its own source id
+        threads = [threading.Thread(target=lambda i=i: results.append(replay(args, requests, f"replay{i}")))
+                   for i in range(args.senders)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+    else:
+        results.append(replay(args, requests, None))
+    elapsed = time.perf_counter() - run_start
+    after = fetch_stats(args.host, args.port)
+
+    latencies = [latency for result in results for latency in result[0]]
+    total_bytes = sum(result[1] for result in results)
+    failures = sum(result[2] for result in results)
+    latencies.sort()
+    print(f"requests: {len(latencies)} ok, {failures} failed in {elapsed:.2f} s")
+    if latencies:
+        print(f"throughput: {len(latencies) / elapsed:.1f} frames/s, {total_bytes / elapsed / 1024:.1f} KiB/s")
+        print("latency ms: p50 {:.1f}  p90 {:.1f}  p99 {:.1f}  max {:.1f}".format(
+            *(1000 * percentile(latencies, p) for p in (0.5, 0.9, 0.99)), 1000 * latencies[-1]))
+    for label, stats in (("before", before), ("after", after)):
+        if stats is not None:
+            print(f"{label}: " + ", ".join(f"{k}={v}" for k, v in stats.items()))
+
+
+if __name__ == "__main__":
+    main()